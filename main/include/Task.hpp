@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include "TaskPlan.hpp"
+
+#include "freertos/task.h"
+
 namespace kopter {
 
 class Task {
@@ -25,10 +29,19 @@ public:
     Task(const char *task_name, uint32_t stack_size, TaskFn fn);
     Task(const char *task_name, uint32_t stack_size, UBaseType_t priority, TaskFn fn);
     Task(const char *task_name, uint32_t stack_size, UBaseType_t priority, BaseType_t coreId, TaskFn fn);
+    Task(const char *task_name, uint32_t stack_size, const TaskPlacement &placement, TaskFn fn);
+
+    /**
+     * @brief Returns the handle of the created task, or nullptr if it could not be created.
+     *
+     * Valid as soon as the ctor returns, even if the task has not run yet.
+     */
+    TaskHandle_t get_handle() const noexcept;
 
 private:
     static void task_trampoline(void *param);
     TaskFn m_fn;
+    TaskHandle_t m_handle{nullptr};
 };
 
 } // namespace kopter
\ No newline at end of file
@@ -0,0 +1,80 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+#include <algorithm>
+
+namespace kopter {
+
+/**
+ * @brief Priority and core of a task.
+ */
+struct TaskPlacement {
+    /// FreeRTOS priority.
+    UBaseType_t priority;
+
+    /// Core the task is pinned to.
+    BaseType_t core_id;
+};
+
+/**
+ * @brief Core-affinity and priority plan of all application tasks.
+ *
+ * Networking (Wi-Fi, ESP-NOW, the event loops, message reception, OTA) and housekeeping run on the network core.
+ * Sensor acquisition and the control loop run on the flight core, so Wi-Fi interrupts and bursts of network work
+ * do not add jitter to the control loop. Data only crosses between the cores through lock-free buffers such as
+ * `SetpointChannel`.
+ *
+ * The cores and the control loop priority are set in Kconfig (`TASK_PLAN_*`, `CONTROL_LOOP_TASK_PRIORITY`); the
+ * remaining priorities are ordered relative to them here. On single-core targets both cores resolve to core 0 and
+ * the priorities alone order the tasks.
+ *
+ * @note The Wi-Fi task and the esp_timer interrupt are placed by sdkconfig (`ESP_WIFI_TASK_PINNED_TO_CORE_*`,
+ *       `ESP_TIMER_ISR_AFFINITY_*`) and must match the cores chosen here.
+ */
+struct TaskPlan {
+    /// Core running Wi-Fi, ESP-NOW, the event loops and other non-flight work.
+    static constexpr BaseType_t NETWORK_CORE = std::min(CONFIG_TASK_PLAN_NETWORK_CORE, portNUM_PROCESSORS - 1);
+
+    /// Core running sensor acquisition and the control loop.
+    static constexpr BaseType_t FLIGHT_CORE = std::min(CONFIG_TASK_PLAN_FLIGHT_CORE, portNUM_PROCESSORS - 1);
+
+    /// Fixed-rate control loop, see `ControlLoop`.
+    static constexpr TaskPlacement CONTROL_LOOP{CONFIG_CONTROL_LOOP_TASK_PRIORITY, FLIGHT_CORE};
+
+    /// I2C bus task, see `I2cBusScheduler`. Above the control loop, so a transaction it waits for starts at once.
+    static constexpr TaskPlacement I2C_BUS{CONFIG_CONTROL_LOOP_TASK_PRIORITY + 1, FLIGHT_CORE};
+
+    /// One-shot creation of the sensors, so their bus interrupts are allocated on the flight core.
+    static constexpr TaskPlacement FLIGHT_INIT{5, FLIGHT_CORE};
+
+    /// Reception of messages from the radio link, see `CommunicationService`.
+    static constexpr TaskPlacement MESSAGE_RX{10, NETWORK_CORE};
+
+    /// Custom event loop of `EventService`.
+    static constexpr TaskPlacement EVENT_LOOP{5, NETWORK_CORE};
+
+    /// Firmware download, see `OTAService`.
+    static constexpr TaskPlacement OTA{3, NETWORK_CORE};
+
+    /// LED blinking, see `LEDService`.
+    static constexpr TaskPlacement LED{2, NETWORK_CORE};
+};
+
+} // namespace kopter
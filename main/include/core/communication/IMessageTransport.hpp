@@ -50,9 +50,9 @@ struct IMessageTransport {
      *
      * This default implementation does nothing. Transports that require it
      * should override this method to store the queue handle and push received
-     * message buffers into it from ISR callbacks.
+     * messages into it from ISR callbacks.
      *
-     * @param rx_queue A handle to a FreeRTOS queue for message reception.
+     * @param rx_queue A handle to a FreeRTOS queue for message reception. Items are `Message`s copied by value.
      */
     virtual void attach_rx_queue(QueueHandle_t rx_queue)
     {
@@ -26,7 +26,17 @@ enum class MessageType : uint8_t {
     READ,
 
     /** Message to send control data (e.g. motor commands).*/
-    WRITE
+    WRITE,
+
+    /** Message to set the QNH, see `Message::make_qnh` and `Message::get_qnh_dhpa`.*/
+    QNH,
+
+    /** Message to run the guided accelerometer calibration at the next boot; the payload is ignored.*/
+    CALIBRATE_ACCEL,
+
+    /** Message to arm or disarm, see `Message::make_arm` and `Message::is_arm_request`. Disarming stops the motors
+     * at once, arming takes effect with the next WRITE message.*/
+    ARM
 };
 
 /**
@@ -34,6 +44,12 @@ enum class MessageType : uint8_t {
  *
  * This structure is packed and meant to be serialized into a raw byte buffer for transmission,
  * or deserialized from such buffer. It contains essential fields for drone control or telemetry exchange.
+ *
+ * Only READ and WRITE use the stick fields as such. The other types carry their payload in the same bytes; use the
+ * `make_*` factories and getters below instead of packing it by hand:
+ * - QNH: the QNH in units of 0.1 hPa as a little-endian uint16, low byte in `throttle`, high byte in `roll`.
+ * - ARM: `throttle` above 0 arms, 0 disarms.
+ * - CALIBRATE_ACCEL: no payload.
  */
 struct [[gnu::packed]] Message {
 
@@ -60,6 +76,28 @@ struct [[gnu::packed]] Message {
      */
     void serialize(uint8_t *buffer) const;
 
+    /**
+     * @brief Creates a QNH message.
+     *
+     * @param qnh_dhpa Sea-level pressure in units of 0.1 hPa, e.g. 10132 for 1013.2 hPa.
+     */
+    static Message make_qnh(uint16_t qnh_dhpa) noexcept;
+
+    /**
+     * @brief Returns the QNH of a QNH message in units of 0.1 hPa.
+     */
+    uint16_t get_qnh_dhpa() const noexcept;
+
+    /**
+     * @brief Creates an ARM message that arms or disarms the vehicle.
+     */
+    static Message make_arm(bool armed) noexcept;
+
+    /**
+     * @brief Returns whether an ARM message arms (true) or disarms (false) the vehicle.
+     */
+    bool is_arm_request() const noexcept;
+
     /**
      * @brief Type of the message (e.g. READ or WRITE).
      */
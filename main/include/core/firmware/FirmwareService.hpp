@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include "IMUData.hpp"
+
 #include "nvs_handle.hpp"
 
 namespace kopter {
@@ -23,7 +25,7 @@ namespace kopter {
 /**
  * @brief Service for managing firmware.
  *
- * This class provides access to read and write the firmware version number
+ * This class provides access to read and write the firmware version number and the sensor calibration
  * stored persistently on the ESP32's flash memory using the NVS subsystem.
  *
  * It is implemented as a thread-safe singleton and handles NVS initialization internally.
@@ -67,9 +69,68 @@ public:
      */
     void set_version(const uint16_t new_version);
 
+    /**
+     * @brief Get the stored gyroscope bias.
+     *
+     * @return The bias stored by `set_gyro_bias`, or nothing if none is stored or NVS cannot be opened.
+     */
+    std::optional<GyroBias> get_gyro_bias();
+
+    /**
+     * @brief Store the gyroscope bias.
+     *
+     * Failures are logged and otherwise ignored: a missing bias only costs a full calibration at the next boot.
+     *
+     * @param bias The bias to store.
+     */
+    void set_gyro_bias(const GyroBias &bias);
+
+    /**
+     * @brief Get the stored accelerometer correction.
+     *
+     * @return The correction stored by `set_accel_correction`, or nothing if none is stored or NVS cannot be opened.
+     */
+    std::optional<AccelCorrection> get_accel_correction();
+
+    /**
+     * @brief Store the accelerometer correction.
+     *
+     * Failures are logged and otherwise ignored.
+     *
+     * @param correction The correction to store.
+     */
+    void set_accel_correction(const AccelCorrection &correction);
+
+    /**
+     * @brief Whether the guided accelerometer calibration was requested for the next boot.
+     *
+     * @return The flag stored by `set_accel_calibration_requested`, or false if none is stored or NVS cannot be
+     * opened.
+     */
+    bool is_accel_calibration_requested();
+
+    /**
+     * @brief Store whether the guided accelerometer calibration is to run at the next boot.
+     *
+     * Failures are logged and otherwise ignored.
+     *
+     * @param requested Whether the calibration is requested.
+     */
+    void set_accel_calibration_requested(bool requested);
+
 private:
     FirmwareService();
 
+    /**
+     * @brief Reads a trivially copyable value stored as a blob, rejecting blobs of another size.
+     */
+    template <typename T> std::optional<T> get_blob(std::string_view key);
+
+    /**
+     * @brief Stores a trivially copyable value as a blob and commits it. Failures are logged.
+     */
+    template <typename T> void set_blob(std::string_view key, const T &value);
+
     std::unique_ptr<nvs::NVSHandle> open_nvs();
 };
 
@@ -0,0 +1,132 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#pragma once
+
+#include "I2cTransaction.hpp"
+#include "Task.hpp"
+
+#include "freertos/queue.h"
+
+#include <array>
+#include <atomic>
+
+namespace kopter {
+
+/**
+ * @brief Queueing statistics of one `I2cPriority` level of an `I2cBusScheduler`.
+ */
+struct I2cQueueStats {
+    /// Transactions executed.
+    uint32_t completed;
+
+    /// Most transactions waiting at once, the executed one included.
+    uint32_t max_depth;
+
+    /// Summed time from submission to the start of execution, in microseconds.
+    uint32_t total_wait_us;
+
+    /// Longest time from submission to the start of execution, in microseconds.
+    uint32_t max_wait_us;
+};
+
+/**
+ * @brief Bus task serializing all transactions on the I2C port by priority.
+ *
+ * Transactions are queued per `I2cPriority` and the bus task always executes the oldest transaction of the
+ * highest non-empty level, so an IMU read never waits behind more than the one transaction already on the
+ * wire. The task runs on the flight core just above the control loop: it sleeps while the hardware clocks a
+ * transfer, so a caller that submitted asynchronously keeps computing in the meantime.
+ *
+ * `submit` is asynchronous and completes through the transaction callback; `run` blocks the caller on a
+ * semaphore of its own, leaving its task notifications to e.g. `ControlLoop`. Neither allocates. The drivers go
+ * through `I2cDevice`, which uses `run`; no driver submits asynchronously yet, so today the scheduler orders the
+ * bus by priority but does not overlap transfers with computation.
+ *
+ * The statistics are plain atomics written only by the bus task.
+ *
+ * The scheduler lives for the rest of the process: the bus task never exits and the queues are never deleted, so
+ * the destructor is deleted and an instance can only be created with `new` and never freed.
+ */
+class I2cBusScheduler {
+public:
+    /**
+     * @brief Creates the queues and starts the bus task.
+     */
+    I2cBusScheduler();
+
+    I2cBusScheduler(const I2cBusScheduler &) = delete;
+    I2cBusScheduler &operator=(const I2cBusScheduler &) = delete;
+    ~I2cBusScheduler() = delete;
+
+    /**
+     * @brief Queues a transaction at the priority of its device and returns immediately.
+     *
+     * @param transaction Transaction to execute. Must stay alive until its `on_complete` runs.
+     *
+     * @throws I2cException with `ESP_ERR_NO_MEM` if the queue of the priority is full.
+     */
+    void submit(I2cTransaction &transaction);
+
+    /**
+     * @brief Queues a transaction and waits for it to complete.
+     *
+     * Executes the transaction in place when called from the bus task, e.g. from a completion callback.
+     * `on_complete` and `context` of the transaction are overwritten.
+     *
+     * @param transaction Transaction to execute; `result` holds the outcome on return.
+     *
+     * @throws I2cException with `ESP_ERR_NO_MEM` if the queue of the priority is full.
+     */
+    void run(I2cTransaction &transaction);
+
+    /**
+     * @brief Returns the number of transactions currently waiting at a priority.
+     */
+    uint32_t get_depth(I2cPriority priority) const noexcept;
+
+    /**
+     * @brief Returns the queueing statistics of a priority since the last reset.
+     */
+    I2cQueueStats get_stats(I2cPriority priority) const noexcept;
+
+    /**
+     * @brief Requests the statistics to be cleared before the next transaction.
+     */
+    void reset_stats() noexcept;
+
+private:
+    struct QueueCounters {
+        std::atomic<uint32_t> completed{0};
+        std::atomic<uint32_t> max_depth{0};
+        std::atomic<uint32_t> total_wait_us{0};
+        std::atomic<uint32_t> max_wait_us{0};
+    };
+
+    void process();
+    bool enqueue(I2cTransaction &transaction);
+    I2cTransaction *pop(size_t &level);
+    void execute(I2cTransaction &transaction, QueueCounters &counters, uint32_t depth);
+
+    std::array<QueueHandle_t, I2C_PRIORITY_COUNT> m_queues{};
+    std::array<QueueCounters, I2C_PRIORITY_COUNT> m_counters;
+    std::atomic<bool> m_reset_requested{false};
+    std::atomic<TaskHandle_t> m_task_handle{nullptr};
+    std::unique_ptr<Task> m_task;
+};
+
+} // namespace kopter
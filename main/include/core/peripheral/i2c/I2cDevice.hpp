@@ -17,28 +17,63 @@
 #pragma once
 
 #include "I2cException.hpp"
+#include "I2cTransaction.hpp"
 #include "IDevice.hpp"
 
-#include "i2c_cxx.hpp"
+#include "driver/i2c.h"
+
+#include <array>
+#include <atomic>
+#include <span>
 
 namespace kopter {
 
+class I2cBusScheduler;
+
 /**
- * @brief Represents a generic I2C device connected to a shared I2C master.
+ * @brief Transaction statistics of an `I2cDevice`.
+ */
+struct I2cStats {
+    /// Bus transactions started, failed ones included.
+    uint32_t transactions;
+
+    /// Transactions that returned an error.
+    uint32_t errors;
+
+    /// Summed duration of all transactions, in microseconds.
+    uint32_t total_us;
+
+    /// Longest transaction, in microseconds.
+    uint32_t max_us;
+};
+
+/**
+ * @brief Represents a generic I2C device connected to a shared I2C port.
+ *
+ * This class provides an abstraction over an I2C device that communicates via the I2C port installed by
+ * `I2cDeviceHolder`. Every transfer goes through caller-provided buffers, and the command links of the
+ * underlying transactions live on the stack, so no call allocates and all of them are safe in the flight loop.
+ *
+ * Each call is a single bus transaction. With an `I2cBusScheduler` the calls are queued at the priority of the
+ * device and block until the bus task has executed them; without one they run on the calling task.
  *
- * This class provides an abstraction over an I2C device that communicates via a shared I2C master interface.
- * It enables sending and receiving data over I2C using high-level C++ constructs, and can be extended by
- * specific device implementations (e.g. MPU6050, EEPROM, etc.).
+ * The duration of every transaction is recorded in `I2cStats`. The statistics are plain atomics written only by
+ * the task executing the transactions, so any task may read them.
  */
 class I2cDevice : public IDevice {
 public:
+    /// Maximum payload of a register write, limited by the stack buffer that prepends the register address.
+    static constexpr size_t MAX_WRITE_BYTES = 32;
+
     /**
-     * @brief Ctor for an I2cDevice with a name, I2C address, and a shared I2C master.
+     * @brief Ctor for an I2cDevice with an I2C address on an installed I2C port.
      *
      * @param address I2C address of the device.
-     * @param shared_master Pointer to a shared I2CMaster instance responsible for communication.
+     * @param port I2C port the driver was installed on.
+     * @param priority Priority of the transactions of the device on the bus.
+     * @param scheduler Bus task executing the transactions, or `nullptr` to run them on the calling task.
      */
-    I2cDevice(const idf::I2CAddress &address, idf::I2CMaster *shared_master);
+    I2cDevice(uint8_t address, i2c_port_t port, I2cPriority priority, I2cBusScheduler *scheduler);
 
     /**
      * @brief Virtual dtor.
@@ -54,35 +89,97 @@ public:
     virtual const char *get_name() const noexcept override;
 
     /**
-     * @brief Writes a buffer of bytes to the I2C device.
+     * @brief Writes a buffer of bytes to the I2C device as is.
      *
-     * @param data A vector of bytes to be sent to the device.
+     * @param data Bytes to be sent to the device.
      *
      * @throws I2cException If the write operation fails.
      */
-    void write(const std::vector<uint8_t> &data);
+    void write(std::span<const uint8_t> data);
+
+    /**
+     * @brief Writes a buffer of bytes starting at a specific register.
+     *
+     * @param reg The register address to write to.
+     * @param data Bytes to be written, at most `MAX_WRITE_BYTES`.
+     *
+     * @throws I2cException with `ESP_ERR_INVALID_SIZE` if `data` is too long, or if the write operation fails.
+     */
+    void write(const uint8_t reg, std::span<const uint8_t> data);
 
     /**
-     * @brief Reads a sequence of bytes from a specific register.
+     * @brief Writes a single byte to a specific register.
+     *
+     * @param reg The register address to write to.
+     * @param value The value to be written.
+     *
+     * @throws I2cException If the write operation fails.
+     */
+    void write(const uint8_t reg, const uint8_t value);
+
+    /**
+     * @brief Reads `data.size()` bytes starting at a specific register into a caller-provided buffer.
+     *
+     * The register address is written and the data read back in one transaction joined by a repeated start,
+     * so there is no STOP in between that would let another master take the bus.
      *
      * @param reg The register address to read from.
-     * @param n_bytes Number of bytes to read.
-     * @return A vector containing the read bytes.
+     * @param data Buffer receiving the read bytes.
      *
      * @throws I2cException If the read operation fails.
      */
-    std::vector<uint8_t> read(const uint8_t reg, const uint16_t n_bytes);
+    void read(const uint8_t reg, std::span<uint8_t> data);
 
     /**
      * @brief Returns the I2C address of the device.
      *
-     * @return The I2CAddress instance representing the device's address.
+     * @return The 7-bit I2C address of the device.
+     */
+    uint8_t get_address() const noexcept;
+
+    /**
+     * @brief Returns the priority of the transactions of the device on the bus.
      */
-    const idf::I2CAddress &get_address() const noexcept;
+    I2cPriority get_priority() const noexcept;
+
+    /**
+     * @brief Executes a transaction on the bus right away and records it in the statistics.
+     *
+     * Called by `I2cBusScheduler` on the bus task; drivers use `read` and `write` instead.
+     *
+     * @param transaction Transaction of this device; `result` holds the outcome on return.
+     */
+    void execute(I2cTransaction &transaction) noexcept;
+
+    /**
+     * @brief Returns the transaction statistics since the last reset.
+     */
+    I2cStats get_stats() const noexcept;
+
+    /**
+     * @brief Requests the statistics to be cleared before the next transaction.
+     *
+     * Safe to call from a task other than the one using the device.
+     */
+    void reset_stats() noexcept;
 
 private:
-    idf::I2CAddress m_address;
-    idf::I2CMaster *m_master{nullptr};
+    /**
+     * @brief Executes a transaction through the scheduler, if any, and waits for it.
+     *
+     * @throws I2cException if the transaction fails.
+     */
+    void run(I2cTransaction &transaction);
+
+    uint8_t m_address;
+    i2c_port_t m_port;
+    I2cPriority m_priority;
+    I2cBusScheduler *m_scheduler{nullptr};
+    std::atomic<uint32_t> m_transactions;
+    std::atomic<uint32_t> m_errors;
+    std::atomic<uint32_t> m_total_us;
+    std::atomic<uint32_t> m_max_us;
+    std::atomic<bool> m_reset_requested;
 };
 
 } // namespace kopter
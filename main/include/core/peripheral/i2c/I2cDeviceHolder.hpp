@@ -18,22 +18,38 @@
 
 #include "I2cDevice.hpp"
 
+#if CONFIG_I2C_BUS_SCHEDULER
+#include "I2cBusScheduler.hpp"
+#endif
+
+#include <unordered_map>
+
 namespace kopter {
 
 class I2cDeviceHolder {
 public:
     I2cDeviceHolder(const I2cDeviceHolder &) = delete;
     I2cDeviceHolder &operator=(const I2cDeviceHolder &) = delete;
-    ~I2cDeviceHolder() = default;
+    ~I2cDeviceHolder();
 
     static I2cDeviceHolder &get_instance();
-    I2cDevice *add_device(const std::string &name, const uint8_t &address);
+    I2cDevice *add_device(const std::string &name,
+                          const uint8_t &address,
+                          I2cPriority priority = I2cPriority::HOUSEKEEPING);
+
+    /**
+     * @brief Logs the transaction statistics of every device and of the bus scheduler, and resets them.
+     */
+    void log_stats();
 
 private:
     I2cDeviceHolder();
 
-    std::unique_ptr<idf::I2CMaster> m_master{nullptr};
     std::unordered_map<std::string, std::unique_ptr<I2cDevice>> m_devices;
+#if CONFIG_I2C_BUS_SCHEDULER
+    // Lives for the rest of the process, see `I2cBusScheduler`.
+    I2cBusScheduler *m_scheduler{nullptr};
+#endif
 };
 
 } // namespace kopter
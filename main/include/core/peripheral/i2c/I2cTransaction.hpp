@@ -0,0 +1,74 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#pragma once
+
+#include "esp_err.h"
+
+#include <span>
+
+namespace kopter {
+
+class I2cDevice;
+
+/**
+ * @brief Priority of the transactions of an `I2cDevice` on the shared bus, highest first.
+ */
+enum class I2cPriority : uint8_t {
+    IMU = 0,
+    BAROMETER,
+    HOUSEKEEPING,
+};
+
+/// Number of `I2cPriority` levels.
+constexpr size_t I2C_PRIORITY_COUNT = 3;
+
+/**
+ * @brief One bus transaction: a write, optionally followed by a read after a repeated start.
+ *
+ * The transaction and the buffers it points to are owned by the caller and must stay alive until
+ * `on_complete` runs, so queuing one never allocates.
+ */
+struct I2cTransaction {
+    /**
+     * @brief Completion callback. Runs on the bus task and must not block.
+     */
+    using Callback = void (*)(I2cTransaction &transaction, void *context);
+
+    /// Target device.
+    I2cDevice *device = nullptr;
+
+    /// Bytes written first; for a register read just the register address.
+    std::span<const uint8_t> write_data;
+
+    /// Bytes read back after a repeated start; empty for a plain write.
+    std::span<uint8_t> read_data;
+
+    /// Called once the transaction is done, successfully or not.
+    Callback on_complete = nullptr;
+
+    /// Passed to `on_complete` as is.
+    void *context = nullptr;
+
+    /// Outcome of the transfer, set before `on_complete` runs.
+    esp_err_t result = ESP_OK;
+
+    /// Time the transaction was queued, in microseconds on the esp_timer clock.
+    int64_t submitted_us = 0;
+};
+
+} // namespace kopter
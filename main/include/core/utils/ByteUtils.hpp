@@ -40,6 +40,22 @@ struct ByteUtils {
         return static_cast<int16_t>(h) << 8 | l;
     }
 
+    /**
+     * @brief Combines two bytes into an unsigned 16-bit integer (big-endian).
+     */
+    static constexpr uint16_t get_u16_be(uint8_t h, uint8_t l)
+    {
+        return static_cast<uint16_t>(h) << 8 | l;
+    }
+
+    /**
+     * @brief Combines two bytes into a signed 16-bit integer (big-endian).
+     */
+    static constexpr int16_t get_s16_be(uint8_t h, uint8_t l)
+    {
+        return static_cast<int16_t>(static_cast<uint16_t>(h) << 8 | l);
+    }
+
     /**
      * @brief Writes a 16-bit unsigned integer to a 8-bit unsigned int buffer in little-endian order.
      *
@@ -0,0 +1,58 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace kopter {
+
+/**
+ * @brief Running mean and sample standard deviation of a series (Welford's algorithm, stable in single precision).
+ */
+struct RunningStats {
+    /**
+     * @brief Adds a value to the series.
+     */
+    void add(float value) noexcept
+    {
+        ++count;
+        const float delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+    }
+
+    /**
+     * @brief Returns the sample standard deviation, 0 for fewer than two values.
+     */
+    float get_std() const noexcept
+    {
+        return count > 1 ? std::sqrt(m2 / (count - 1)) : 0.0f;
+    }
+
+    /// Number of values added.
+    uint32_t count = 0;
+
+    /// Mean of the values added.
+    float mean = 0.0f;
+
+    /// Sum of squared deviations from the mean.
+    float m2 = 0.0f;
+};
+
+} // namespace kopter
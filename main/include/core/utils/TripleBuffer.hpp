@@ -0,0 +1,99 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace kopter {
+
+/**
+ * @brief Wait-free single-producer/single-consumer triple buffer.
+ *
+ * The writer fills `write_buffer()` and calls `publish()`; the reader calls `update()` and then reads
+ * `read_buffer()`. Both sides only ever swap a slot index with one atomic exchange, so neither side waits
+ * for the other. The reader always sees the latest published value; values published between two
+ * `update()` calls are overwritten.
+ *
+ * Example usage:
+ * ```
+ * TripleBuffer<Setpoint> buffer;
+ * // writer
+ * buffer.write_buffer() = setpoint;
+ * buffer.publish();
+ * // reader
+ * if (buffer.update()) {
+ *     use(buffer.read_buffer());
+ * }
+ * ```
+ *
+ * @tparam T Value type. Must be default constructible and copy assignable.
+ */
+template <typename T> class TripleBuffer {
+public:
+    /**
+     * @brief Returns the slot owned by the writer.
+     */
+    T &write_buffer() noexcept
+    {
+        return m_slots[m_write_index];
+    }
+
+    /**
+     * @brief Publishes the writer slot and takes over the previous middle slot for the next write.
+     */
+    void publish() noexcept
+    {
+        const uint8_t previous = m_middle.exchange(m_write_index | FRESH, std::memory_order_acq_rel);
+        m_write_index = previous & INDEX_MASK;
+    }
+
+    /**
+     * @brief Takes over the latest published slot, if there is one the reader has not seen yet.
+     *
+     * @return true if `read_buffer()` now holds a newly published value.
+     */
+    bool update() noexcept
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        const uint8_t previous = m_middle.exchange(m_read_index, std::memory_order_acq_rel);
+        m_read_index = previous & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief Returns the slot owned by the reader.
+     */
+    const T &read_buffer() const noexcept
+    {
+        return m_slots[m_read_index];
+    }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x03;
+    static constexpr uint8_t FRESH = 0x04;
+
+    std::array<T, 3> m_slots{};
+    std::atomic<uint8_t> m_middle{1};
+    uint8_t m_write_index{0};
+    uint8_t m_read_index{2};
+};
+
+} // namespace kopter
@@ -0,0 +1,230 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+#include "KopterException.hpp"
+#include "Task.hpp"
+
+#include "esp_timer.h"
+
+#include <atomic>
+
+namespace kopter {
+
+/**
+ * @brief Timing statistics collected by the `ControlLoop`.
+ *
+ * All durations are in microseconds and measured with `esp_timer_get_time()`.
+ */
+struct ControlLoopStats {
+    /// Number of completed control iterations.
+    uint32_t iterations;
+
+    /// Iterations that either ran longer than the period or started after one or more ticks were missed.
+    uint32_t overruns;
+
+    /// Timer ticks that were coalesced because the previous iteration had not finished yet.
+    uint32_t missed_ticks;
+
+    /// Iterations in which the controller's `update_speed` threw.
+    uint32_t errors;
+
+    /// Start-to-start distance between the last two iterations.
+    int64_t last_period_us;
+
+    /// Shortest observed start-to-start distance.
+    int64_t min_period_us;
+
+    /// Longest observed start-to-start distance.
+    int64_t max_period_us;
+
+    /// Largest absolute deviation of the period from the nominal one.
+    int64_t max_jitter_us;
+
+    /// Execution time of the last iteration.
+    int64_t last_exec_us;
+
+    /// Longest observed execution time.
+    int64_t max_exec_us;
+};
+
+/**
+ * @brief What wakes the control task for an iteration.
+ */
+enum class ControlLoopTrigger {
+    /// The periodic timer of the loop.
+    TIMER,
+
+    /// Calls of `ControlLoop::trigger_from_isr`, e.g. from the data-ready interrupt of the IMU.
+    EXTERNAL,
+};
+
+/**
+ * @brief Fixed-rate runner for the `update_speed` of a `FlightController` or any other `FlightPipeline`.
+ *
+ * A periodic `esp_timer` wakes a dedicated high-priority task pinned to a single core, which then
+ * runs one iteration of the flight control loop. The runner records the period, jitter, execution time
+ * and overruns of every iteration so the achieved loop rate can be verified at runtime.
+ *
+ * The rate is taken from Kconfig (`CONTROL_LOOP_RATE_HZ`), priority and core from `TaskPlan::CONTROL_LOOP`.
+ *
+ * Alternatively the loop can be paced by an interrupt, typically the data-ready line of the IMU, so every
+ * iteration starts right after a new sample exists; the rate then only sets the nominal period of the statistics.
+ *
+ * Example usage:
+ * ```
+ * ControlLoop loop(*controller);
+ * loop.start();
+ * ...
+ * auto stats = loop.get_stats();
+ * ```
+ */
+class ControlLoop {
+public:
+    /**
+     * @brief Ctor for a ControlLoop driving the given controller.
+     *
+     * The controller is called through a plain function pointer, so a statically composed `FlightPipeline`
+     * keeps its inlined `update_speed`.
+     *
+     * @tparam Controller Type providing `void update_speed(uint64_t micros)`.
+     * @param controller Flight controller to be updated on every tick. Must outlive the loop.
+     * @param rate_hz Loop rate in Hz.
+     *
+     * @throws KopterException if the periodic timer could not be created.
+     */
+    template <typename Controller>
+    explicit ControlLoop(Controller &controller, uint32_t rate_hz = CONFIG_CONTROL_LOOP_RATE_HZ)
+        : ControlLoop(&ControlLoop::step<Controller>, &controller, rate_hz)
+    {
+    }
+
+    ControlLoop(const ControlLoop &) = delete;
+    ControlLoop &operator=(const ControlLoop &) = delete;
+
+    /**
+     * @brief Dtor. Stops the loop and releases the timer.
+     */
+    ~ControlLoop();
+
+    /**
+     * @brief Creates the control task and, for `ControlLoopTrigger::TIMER`, starts the periodic timer.
+     *
+     * Does nothing if the loop is already running. The task handle is published before returning, so `stop()`
+     * can join the task even if it has not been scheduled yet.
+     *
+     * @param trigger What wakes the control task.
+     *
+     * @throws KopterException if the task could not be created or the timer could not be started.
+     */
+    void start(ControlLoopTrigger trigger = ControlLoopTrigger::TIMER);
+
+    /**
+     * @brief Stops the timer and blocks until the control task has left `run()`.
+     *
+     * Must not be called from the control task itself.
+     */
+    void stop();
+
+    /**
+     * @brief Returns a consistent snapshot of the timing statistics.
+     */
+    ControlLoopStats get_stats() const;
+
+    /**
+     * @brief Clears the timing statistics.
+     */
+    void reset_stats();
+
+    /**
+     * @brief Returns the nominal loop period in microseconds.
+     */
+    constexpr uint32_t get_period_us() const noexcept
+    {
+        return m_period_us;
+    }
+
+    /**
+     * @brief Wakes the control task for one iteration. For loops started with `ControlLoopTrigger::EXTERNAL`.
+     *
+     * Must be called from an interrupt handler; does nothing until the control task runs.
+     *
+     * @param arg The `ControlLoop`.
+     */
+    static void IRAM_ATTR trigger_from_isr(void *arg);
+
+private:
+    /// Runs one iteration of the controller passed as `context`.
+    using StepFn = void (*)(void *context, uint64_t micros);
+
+    /**
+     * @brief Ctor for a ControlLoop calling `step_fn(context, now)` on every tick.
+     */
+    ControlLoop(StepFn step_fn, void *context, uint32_t rate_hz);
+
+    /**
+     * @brief Type-restoring trampoline stored in `m_step_fn`.
+     */
+    template <typename Controller> static void step(void *context, uint64_t micros)
+    {
+        static_cast<Controller *>(context)->update_speed(micros);
+    }
+
+    /**
+     * @brief Periodic timer callback. Wakes up the control task.
+     */
+    static void IRAM_ATTR on_timer_cb(void *arg);
+
+    /**
+     * @brief Body of the control task.
+     */
+    void run();
+
+    /**
+     * @brief Updates statistics after one iteration.
+     *
+     * @param start_us Iteration start time.
+     * @param end_us Iteration end time.
+     * @param pending Number of timer notifications consumed by this iteration.
+     */
+    void record(int64_t start_us, int64_t end_us, uint32_t pending);
+
+    /**
+     * @brief Logs a failed iteration, at most once per second with the number of failures since the last report.
+     *
+     * @param e Exception thrown by the step function.
+     * @param now_us Start time of the failed iteration.
+     */
+    void log_error(const KopterException &e, int64_t now_us);
+
+    StepFn m_step_fn;
+    void *m_context;
+    uint32_t m_period_us;
+    esp_timer_handle_t m_timer;
+    std::unique_ptr<Task> m_task;
+    std::atomic<TaskHandle_t> m_task_handle{nullptr};
+    StaticSemaphore_t m_exited_storage;
+    SemaphoreHandle_t m_exited;
+    std::atomic<bool> m_running{false};
+    int64_t m_last_start_us;
+    int64_t m_last_error_log_us;
+    uint32_t m_unlogged_errors;
+    mutable portMUX_TYPE m_stats_lock;
+    ControlLoopStats m_stats;
+};
+
+} // namespace kopter
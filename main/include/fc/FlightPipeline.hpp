@@ -0,0 +1,414 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+#include "AltitudeReference.hpp"
+#include "CascadePID.hpp"
+#include "IBarometer.hpp"
+#include "IMotor.hpp"
+#include "IMotorMixer.hpp"
+#include "IMU.hpp"
+#include "IOrientationFilter.hpp"
+#include "LoopProfiler.hpp"
+#include "PID.hpp"
+#include "SetpointChannel.hpp"
+#include "VerticalEstimator.hpp"
+
+#include <array>
+
+namespace kopter {
+
+/**
+ * @brief Rate dividers of the nested loops run by `FlightPipeline::update_speed`.
+ *
+ * The inner loop (IMU read, orientation filter, rate PIDs, mixer and motors) runs on every call. The attitude loop
+ * runs on every `attitude`-th call and the altitude loop on every `altitude`-th call. A divider of 1
+ * runs the loop on every call.
+ */
+struct LoopDividers {
+    /// Divider of the attitude loop (Euler extraction and the angle stage of roll/pitch/yaw).
+    uint32_t attitude = 1;
+
+    /// Divider of the altitude loop (barometer read and altitude PID).
+    uint32_t altitude = 1;
+};
+
+namespace detail {
+
+/**
+ * @brief Returns the component itself. Used for components held by value.
+ */
+template <typename T> constexpr T &deref(T &component) noexcept
+{
+    return component;
+}
+
+/**
+ * @brief Returns the pointee. Used for components held through an owning pointer.
+ */
+template <typename T> constexpr T &deref(std::unique_ptr<T> &component) noexcept
+{
+    return *component;
+}
+
+} // namespace detail
+
+/**
+ * @brief Flight control pipeline composed at compile time.
+ *
+ * Implements one iteration of the flight control loop: applies the newest pilot `Setpoint`, reads the IMU, updates
+ * the orientation filter, runs the cascaded roll/pitch/yaw controllers and the altitude PID at their
+ * `LoopDividers`, mixes the outputs and sets the motor speeds.
+ *
+ * Each component type is either a concrete class held by value or a `std::unique_ptr` to an interface. With
+ * concrete types the compiler sees the dynamic type of every component, so the calls are resolved statically and
+ * can be inlined across stages. With `std::unique_ptr` the calls go through the vtable; `FlightController` is that
+ * instantiation and is the one to use when components are chosen at runtime.
+ *
+ * @tparam Imu `IMU` implementation or `std::unique_ptr<IMU>`.
+ * @tparam Barometer `IBarometer` implementation or `std::unique_ptr<IBarometer>`.
+ * @tparam Filter `IOrientationFilter` implementation or `std::unique_ptr<IOrientationFilter>`.
+ * @tparam Mixer `IMotorMixer` implementation or `std::unique_ptr<IMotorMixer>`.
+ * @tparam Motor `IMotor` implementation or `std::unique_ptr<IMotor>`.
+ *
+ * Example usage:
+ * ```
+ * FlightPipeline<MPU6050, BMP280, ComplementaryFilter, XMotorMixer, BDCMotor> pipeline(
+ *     MPU6050(0x68), BMP280(0x76), ComplementaryFilter(), XMotorMixer(), std::array<BDCMotor, 4>{...});
+ * pipeline.update_speed(esp_timer_get_time());
+ * ```
+ */
+template <typename Imu, typename Barometer, typename Filter, typename Mixer, typename Motor> class FlightPipeline {
+public:
+    /**
+     * @brief Ctor for a new FlightPipeline instance.
+     *
+     * @param imu Inertial Measurement Unit providing accelerometer and gyroscope data.
+     * @param barometer Sensor used to measure atmospheric pressure and estimate altitude.
+     * @param orientation_filter Filter that estimates orientation as a quaternion.
+     * @param motor_mixer Mixer that translates control signals into motor throttle values.
+     * @param motors Motors in the order expected by the mixer.
+     * @param roll_controller Optional custom cascade controller for roll. If nullptr, a default controller is used.
+     * @param pitch_controller Optional custom cascade controller for pitch. If nullptr, a default controller is used.
+     * @param yaw_controller Optional custom cascade controller for yaw. If nullptr, a default controller is used.
+     * @param pid_altitude Optional custom PID controller for altitude. If nullptr, a default controller is used.
+     */
+    FlightPipeline(Imu imu,
+                   Barometer barometer,
+                   Filter orientation_filter,
+                   Mixer motor_mixer,
+                   std::array<Motor, 4> motors,
+                   std::unique_ptr<CascadePID> roll_controller = nullptr,
+                   std::unique_ptr<CascadePID> pitch_controller = nullptr,
+                   std::unique_ptr<CascadePID> yaw_controller = nullptr,
+                   std::unique_ptr<PID> pid_altitude = nullptr);
+
+    FlightPipeline(const FlightPipeline &) = delete;
+    FlightPipeline &operator=(const FlightPipeline &) = delete;
+
+    /**
+     * @brief Reads sensors, computes control outputs, and updates motor speeds.
+     *
+     * This method performs one iteration of the flight control loop. It:
+     * - Takes over the newest setpoint from the setpoint channel, if one was published since the last call.
+     * - Reads the IMU samples taken since the last call (gyroscope and accelerometer, see `IMU::read_batch`).
+     * - Updates orientation via the quaternion filter and altitude and vertical velocity via the vertical estimator,
+     *   once per sample.
+     * - Converts orientation to Euler angles and computes roll/pitch/yaw rate setpoints (attitude loop).
+     * - Computes roll/pitch/yaw outputs from the measured angular rates (rate loop).
+     * - Reads the barometric pressure and, if it comes from a new conversion, converts it to altitude above the
+     *   takeoff point and corrects the vertical estimator with it. Computes the altitude PID output from the
+     *   estimate (altitude loop).
+     * - Mixes outputs into individual motor throttle values.
+     * - Updates motor speeds accordingly. While the setpoint is not `Setpoint::armed`, all motors are set to 0
+     *   regardless of the throttle and the controller outputs.
+     *
+     * The attitude and altitude loops only run on the ticks selected by their `LoopDividers`;
+     * in between, their last outputs are reused.
+     *
+     * This function should be called periodically at a fixed frequency, see `ControlLoop`.
+     *
+     * @param micros Timestamp of the current iteration in microseconds.
+     */
+    void update_speed(uint64_t micros);
+
+    /**
+     * @brief Sets the rate dividers of the attitude and altitude loops.
+     *
+     * The attitude loop runs on the next call and the altitude loop, if its divider is above 1, on the one after.
+     * This one-tick stagger keeps the two out of the same call only if the dividers share a common factor, e.g. 2 and
+     * 64. Coprime dividers, say 2 and 65, still meet once every `attitude * altitude` calls, and an altitude divider
+     * of 1 runs alongside every attitude update. Dividers of 0 are treated as 1.
+     *
+     * @param dividers New dividers.
+     *
+     * @note PID gains act per loop iteration, so changing a divider changes the effective gains.
+     */
+    void set_loop_dividers(const LoopDividers &dividers) noexcept;
+
+    /**
+     * @brief Returns the channel through which pilot setpoints are handed to `update_speed`.
+     *
+     * Exactly one task may publish to it, e.g. the `CommunicationService` rx task. Until the first setpoint
+     * arrives the vehicle is disarmed, the collective throttle is 0 and all target angles are 0.
+     */
+    SetpointChannel &get_setpoint_channel() noexcept
+    {
+        return m_setpoints;
+    }
+
+    /**
+     * @brief Returns the reference that turns barometric pressure into the altitude fed to the altitude PID.
+     *
+     * The zero is frozen at the first setpoint with `Setpoint::armed` set and resumes following the weather at the
+     * first one without, so throttling down in the air does not move it. Only `AltitudeReference::set_qnh` may be
+     * called from another task.
+     */
+    AltitudeReference &get_altitude_reference() noexcept
+    {
+        return m_altitude_reference;
+    }
+
+    /**
+     * @brief Returns the estimator of altitude above the takeoff point and vertical velocity, updated at the IMU
+     * rate.
+     */
+    const VerticalEstimator &get_vertical_estimator() const noexcept
+    {
+        return m_vertical_estimator;
+    }
+
+#if CONFIG_FLIGHT_LOOP_PROFILING
+    /**
+     * @brief Returns the per-stage profiler of `update_speed`.
+     */
+    LoopProfiler &get_profiler() noexcept
+    {
+        return m_profiler;
+    }
+#endif
+
+private:
+    /**
+     * @brief Sets the armed state, the collective throttle and the target angles of the axis controllers.
+     */
+    void apply_setpoint(const Setpoint &setpoint);
+
+    /**
+     * @brief Runs the attitude loop: Euler extraction and the angle stage of roll/pitch/yaw.
+     */
+    void update_attitude();
+
+    /**
+     * @brief Runs the altitude loop: barometer read, altitude above the takeoff point and altitude PID.
+     *
+     * The vertical estimator is corrected only with a conversion the barometer has not returned before.
+     */
+    void update_altitude();
+
+    /**
+     * @brief Returns the time a sample was taken, or `micros` for IMUs that do not stamp their samples.
+     */
+    static int64_t get_timestamp_us(const IMUData &sample, uint64_t micros) noexcept
+    {
+        return sample.timestamp_us ? sample.timestamp_us : static_cast<int64_t>(micros);
+    }
+
+    Imu m_imu;
+    std::array<IMUData, IMU::MAX_BATCH> m_imu_batch;
+    std::array<glm::quat, IMU::MAX_BATCH> m_batch_attitudes;
+    IMUData m_imu_data;
+    Barometer m_barometer;
+    Filter m_orientation_filter;
+    Mixer m_motor_mixer;
+    std::array<Motor, 4> m_motors;
+    std::unique_ptr<CascadePID> m_roll_controller;
+    std::unique_ptr<CascadePID> m_pitch_controller;
+    std::unique_ptr<CascadePID> m_yaw_controller;
+    std::unique_ptr<PID> m_pid_altitude;
+    AltitudeReference m_altitude_reference;
+    VerticalEstimator m_vertical_estimator;
+    SetpointChannel m_setpoints;
+    LoopDividers m_dividers;
+    uint32_t m_attitude_countdown;
+    uint32_t m_altitude_countdown;
+    float m_output_roll;
+    float m_output_pitch;
+    float m_output_yaw;
+    float m_output_altitude;
+    float m_collective_throttle;
+    bool m_armed;
+#if CONFIG_FLIGHT_LOOP_PROFILING
+    LoopProfiler m_profiler;
+#endif
+};
+
+template <typename Imu, typename Barometer, typename Filter, typename Mixer, typename Motor>
+FlightPipeline<Imu, Barometer, Filter, Mixer, Motor>::FlightPipeline(Imu imu,
+                                                                     Barometer barometer,
+                                                                     Filter orientation_filter,
+                                                                     Mixer motor_mixer,
+                                                                     std::array<Motor, 4> motors,
+                                                                     std::unique_ptr<CascadePID> roll_controller,
+                                                                     std::unique_ptr<CascadePID> pitch_controller,
+                                                                     std::unique_ptr<CascadePID> yaw_controller,
+                                                                     std::unique_ptr<PID> pid_altitude)
+    : m_imu{std::move(imu)},
+      m_imu_batch{},
+      m_batch_attitudes{},
+      m_imu_data{},
+      m_barometer{std::move(barometer)},
+      m_orientation_filter{std::move(orientation_filter)},
+      m_motor_mixer{std::move(motor_mixer)},
+      m_motors{std::move(motors)},
+      m_roll_controller{roll_controller ? std::move(roll_controller) : std::make_unique<CascadePID>()},
+      m_pitch_controller{pitch_controller ? std::move(pitch_controller) : std::make_unique<CascadePID>()},
+      m_yaw_controller{yaw_controller ? std::move(yaw_controller) : std::make_unique<CascadePID>()},
+      m_pid_altitude{pid_altitude ? std::move(pid_altitude) : std::make_unique<PID>()},
+      m_altitude_reference{},
+      m_vertical_estimator{},
+      m_dividers{},
+      m_attitude_countdown{1},
+      m_altitude_countdown{1},
+      m_output_roll{0.0f},
+      m_output_pitch{0.0f},
+      m_output_yaw{0.0f},
+      m_output_altitude{0.0f},
+      m_collective_throttle{0.0f},
+      m_armed{false}
+{
+}
+
+template <typename Imu, typename Barometer, typename Filter, typename Mixer, typename Motor>
+void FlightPipeline<Imu, Barometer, Filter, Mixer, Motor>::update_speed(uint64_t micros)
+{
+    FC_PROFILE_START(m_profiler);
+    if (const Setpoint *setpoint = m_setpoints.consume(static_cast<int64_t>(micros))) {
+        apply_setpoint(*setpoint);
+    }
+
+    const size_t sample_count = detail::deref(m_imu).read_batch(m_imu_batch);
+    FC_PROFILE_LAP(m_profiler, LoopStage::IMU_READ);
+
+    // Every sample of the batch goes through the filters at the time it was taken; the rate loop uses the newest.
+    // The attitude after each sample is kept for the vertical estimator, which runs as a stage of its own.
+    auto &orientation_filter = detail::deref(m_orientation_filter);
+    for (size_t i = 0; i != sample_count; ++i) {
+        orientation_filter.update(m_imu_batch[i], get_timestamp_us(m_imu_batch[i], micros));
+        m_batch_attitudes[i] = orientation_filter.get_quat();
+    }
+    if (sample_count != 0) {
+        m_imu_data = m_imu_batch[sample_count - 1];
+    }
+    const IMUData &imu_data = m_imu_data;
+    FC_PROFILE_LAP(m_profiler, LoopStage::FILTER_UPDATE);
+
+    for (size_t i = 0; i != sample_count; ++i) {
+        m_vertical_estimator.predict(m_imu_batch[i], m_batch_attitudes[i], get_timestamp_us(m_imu_batch[i], micros));
+    }
+    FC_PROFILE_LAP(m_profiler, LoopStage::VERTICAL_PREDICT);
+
+    if (--m_attitude_countdown == 0) {
+        m_attitude_countdown = m_dividers.attitude;
+        update_attitude();
+    }
+    if (--m_altitude_countdown == 0) {
+        m_altitude_countdown = m_dividers.altitude;
+        update_altitude();
+    }
+
+    m_roll_controller->update_rate(imu_data.gx, m_output_roll);
+    m_pitch_controller->update_rate(imu_data.gy, m_output_pitch);
+    m_yaw_controller->update_rate(imu_data.gz, m_output_yaw);
+    FC_PROFILE_LAP(m_profiler, LoopStage::RATE_PID_UPDATE);
+
+    // Disarmed, the motors stay at 0 whatever the sticks and the controllers ask for.
+    float throttles[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    if (m_armed) {
+        std::fill(std::begin(throttles), std::end(throttles), m_collective_throttle);
+        const MotorMixerConfig cfg{.throttles = throttles,
+                                   .collective_throttle = m_collective_throttle,
+                                   .roll = m_output_roll,
+                                   .pitch = m_output_pitch,
+                                   .yaw = m_output_yaw};
+        detail::deref(m_motor_mixer).mix(cfg);
+    }
+    FC_PROFILE_LAP(m_profiler, LoopStage::MOTOR_MIX);
+
+    detail::deref(m_motors[0]).set_speed(throttles[0]);
+    detail::deref(m_motors[1]).set_speed(throttles[1]);
+    detail::deref(m_motors[2]).set_speed(throttles[2]);
+    detail::deref(m_motors[3]).set_speed(throttles[3]);
+    FC_PROFILE_LAP(m_profiler, LoopStage::MOTOR_OUTPUT);
+}
+
+template <typename Imu, typename Barometer, typename Filter, typename Mixer, typename Motor>
+void FlightPipeline<Imu, Barometer, Filter, Mixer, Motor>::set_loop_dividers(const LoopDividers &dividers) noexcept
+{
+    m_dividers.attitude = std::max<uint32_t>(dividers.attitude, 1);
+    m_dividers.altitude = std::max<uint32_t>(dividers.altitude, 1);
+    m_attitude_countdown = 1;
+    m_altitude_countdown = std::min<uint32_t>(m_dividers.altitude, 2);
+}
+
+template <typename Imu, typename Barometer, typename Filter, typename Mixer, typename Motor>
+void FlightPipeline<Imu, Barometer, Filter, Mixer, Motor>::apply_setpoint(const Setpoint &setpoint)
+{
+    m_armed = setpoint.armed;
+    m_collective_throttle = setpoint.throttle;
+    m_altitude_reference.set_armed(setpoint.armed);
+    m_roll_controller->set_target_angle(setpoint.roll);
+    m_pitch_controller->set_target_angle(setpoint.pitch);
+    m_yaw_controller->set_target_angle(setpoint.yaw);
+}
+
+template <typename Imu, typename Barometer, typename Filter, typename Mixer, typename Motor>
+void FlightPipeline<Imu, Barometer, Filter, Mixer, Motor>::update_attitude()
+{
+    glm::vec3 eulers = glm::eulerAngles(detail::deref(m_orientation_filter).get_quat());
+    float roll = glm::degrees(eulers.x);
+    float pitch = glm::degrees(eulers.y);
+    float yaw = glm::degrees(eulers.z);
+    FC_PROFILE_LAP(m_profiler, LoopStage::EULER_EXTRACTION);
+
+    m_roll_controller->update_angle(roll);
+    m_pitch_controller->update_angle(pitch);
+    m_yaw_controller->update_angle(yaw);
+    FC_PROFILE_LAP(m_profiler, LoopStage::PID_UPDATE);
+}
+
+template <typename Imu, typename Barometer, typename Filter, typename Mixer, typename Motor>
+void FlightPipeline<Imu, Barometer, Filter, Mixer, Motor>::update_altitude()
+{
+    auto &barometer = detail::deref(m_barometer);
+    const float pressure = barometer.read_pressure();
+    const bool new_sample = barometer.has_new_sample();
+    FC_PROFILE_LAP(m_profiler, LoopStage::BARO_READ);
+
+    // A cached conversion would be weighted again as a new measurement and pull the estimate towards stale data.
+    if (new_sample) {
+        if (const std::optional<float> relative_altitude = m_altitude_reference.update(pressure)) {
+            m_vertical_estimator.correct(*relative_altitude);
+        }
+    }
+    FC_PROFILE_LAP(m_profiler, LoopStage::VERTICAL_CORRECT);
+
+    m_pid_altitude->update(m_vertical_estimator.get_altitude(), m_output_altitude);
+    FC_PROFILE_LAP(m_profiler, LoopStage::ALTITUDE_PID_UPDATE);
+}
+
+} // namespace kopter
@@ -0,0 +1,59 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+namespace kopter {
+
+/**
+ * @brief Detects heap allocations made by a guarded task.
+ *
+ * With `CONFIG_FC_HEAP_GUARD` enabled the heap allocation hook checks every successful allocation against the
+ * armed task. Depending on `CONFIG_FC_HEAP_GUARD_ACTION` the allocation is counted, or the system is aborted with
+ * a backtrace pointing at the caller. `ControlLoop` arms the guard for its task while it is running, so the
+ * flight loop must not touch the heap after start-up.
+ *
+ * Throwing an exception allocates too, so a counted violation may also be a failed iteration
+ * (`ControlLoopStats::errors`).
+ */
+struct HeapGuard {
+    /**
+     * @brief Starts guarding the given task. Replaces any previously armed task.
+     *
+     * @param task Task whose allocations are violations.
+     */
+    static void arm(TaskHandle_t task) noexcept;
+
+    /**
+     * @brief Stops guarding.
+     */
+    static void disarm() noexcept;
+
+    /**
+     * @brief Returns the number of allocations made by the guarded task since boot.
+     */
+    static uint32_t get_violations() noexcept;
+
+    /**
+     * @brief Called by the heap allocation hook for every successful allocation.
+     */
+    static void IRAM_ATTR on_allocation() noexcept;
+};
+
+} // namespace kopter
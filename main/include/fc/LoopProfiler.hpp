@@ -0,0 +1,138 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#if CONFIG_FLIGHT_LOOP_PROFILING
+#include "esp_cpu.h"
+#endif
+
+namespace kopter {
+
+/**
+ * @brief Stages of one flight control loop iteration, in execution order.
+ */
+enum class LoopStage : uint8_t {
+    IMU_READ,
+    FILTER_UPDATE,
+    VERTICAL_PREDICT,
+    EULER_EXTRACTION,
+    PID_UPDATE,
+    BARO_READ,
+    VERTICAL_CORRECT,
+    ALTITUDE_PID_UPDATE,
+    RATE_PID_UPDATE,
+    MOTOR_MIX,
+    MOTOR_OUTPUT,
+    COUNT
+};
+
+/**
+ * @brief Accumulated CPU cycle statistics for a single loop stage.
+ */
+struct StageStats {
+    /// Number of histogram buckets. Bucket `i` counts samples in [2^(7+i), 2^(8+i)) cycles, the last one is open.
+    static constexpr size_t HISTOGRAM_BUCKETS = 12;
+
+    /**
+     * @brief Returns the average duration of the stage in cycles, or 0 if nothing was recorded.
+     */
+    constexpr uint32_t get_avg_cycles() const noexcept
+    {
+        return count ? static_cast<uint32_t>(total_cycles / count) : 0;
+    }
+
+    uint32_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    std::array<uint32_t, HISTOGRAM_BUCKETS> histogram;
+};
+
+/**
+ * @brief Per-stage cycle counter for the flight control loop hot path.
+ *
+ * Stages are measured as laps: `start()` takes a reference timestamp and every `lap(stage)` attributes the
+ * cycles elapsed since the previous timestamp to `stage`. Only the control task is expected to call
+ * `start()`/`lap()`; `reset()` may be called from any task and is applied on the next `start()`.
+ *
+ * Use the `FC_PROFILE_START`/`FC_PROFILE_LAP` macros, which compile to nothing unless
+ * `CONFIG_FLIGHT_LOOP_PROFILING` is enabled.
+ */
+class LoopProfiler {
+public:
+    /**
+     * @brief Ctor with cleared statistics.
+     */
+    LoopProfiler() noexcept;
+
+    /**
+     * @brief Takes the reference timestamp for the first stage of an iteration.
+     */
+    void start() noexcept;
+
+    /**
+     * @brief Records the cycles elapsed since the previous timestamp for the given stage.
+     *
+     * @param stage Stage that has just finished.
+     */
+    void lap(LoopStage stage) noexcept;
+
+    /**
+     * @brief Returns the statistics of the given stage.
+     *
+     * @note The copy is not synchronized with the control task and may mix values of two iterations.
+     */
+    StageStats get_stats(LoopStage stage) const noexcept;
+
+    /**
+     * @brief Requests clearing of all statistics.
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief Logs min/avg/max in nanoseconds and the histogram of every stage.
+     */
+    void log_stats() const;
+
+    /**
+     * @brief Returns a printable name of the stage.
+     */
+    static const char *get_stage_name(LoopStage stage) noexcept;
+
+private:
+    /**
+     * @brief Returns the current CPU cycle count.
+     */
+    static uint32_t now() noexcept;
+
+    std::array<StageStats, static_cast<size_t>(LoopStage::COUNT)> m_stats;
+    uint32_t m_last_cycles;
+    std::atomic<bool> m_reset_requested;
+};
+
+} // namespace kopter
+
+#if CONFIG_FLIGHT_LOOP_PROFILING
+#define FC_PROFILE_START(profiler) (profiler).start()
+#define FC_PROFILE_LAP(profiler, stage) (profiler).lap(stage)
+#else
+#define FC_PROFILE_START(profiler)
+#define FC_PROFILE_LAP(profiler, stage)
+#endif
@@ -0,0 +1,125 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+#include "TripleBuffer.hpp"
+
+#include <atomic>
+
+namespace kopter {
+
+/**
+ * @brief Pilot command applied by the flight loop.
+ */
+struct Setpoint {
+    /// Collective throttle in [0, 1].
+    float throttle = 0.0f;
+
+    /// Target roll angle in degrees.
+    float roll = 0.0f;
+
+    /// Target pitch angle in degrees.
+    float pitch = 0.0f;
+
+    /// Target yaw angle in degrees.
+    float yaw = 0.0f;
+
+    /// Whether the pilot has armed the vehicle. While disarmed the motors are held at 0 and the altitude zero
+    /// follows the weather on the ground.
+    bool armed = false;
+
+    /// Time the command was received, in microseconds on the flight loop clock.
+    int64_t timestamp_us = 0;
+
+    /// Sequence number assigned by `SetpointChannel::publish`, starting at 1.
+    uint32_t sequence = 0;
+};
+
+/**
+ * @brief Delivery statistics of a `SetpointChannel`, collected on the reader side.
+ */
+struct SetpointStats {
+    /// Setpoints taken over by the flight loop.
+    uint32_t received;
+
+    /// Setpoints that were replaced by a newer one before the flight loop read them.
+    uint32_t overwritten;
+
+    /// Time from `Setpoint::timestamp_us` to the loop tick that applied the last setpoint.
+    int32_t last_latency_us;
+
+    /// Largest observed latency.
+    int32_t max_latency_us;
+};
+
+/**
+ * @brief Wait-free handoff of setpoints from the radio link to the flight loop.
+ *
+ * One writer (e.g. the `CommunicationService` rx task) publishes setpoints and one reader (the flight loop)
+ * consumes the newest one once per tick. Neither side blocks: the channel is a `TripleBuffer`, and the
+ * statistics are plain atomics written only by the reader.
+ *
+ * The latency recorded here ends at the start of the tick that applies the setpoint; stick-to-motor latency is
+ * that plus the execution time of the tick, which `ControlLoop` reports.
+ */
+class SetpointChannel {
+public:
+    /**
+     * @brief Ctor for an empty channel.
+     */
+    SetpointChannel() noexcept;
+
+    SetpointChannel(const SetpointChannel &) = delete;
+    SetpointChannel &operator=(const SetpointChannel &) = delete;
+
+    /**
+     * @brief Publishes a setpoint. Writer side only.
+     *
+     * @param setpoint Setpoint to publish. Its `sequence` is overwritten with the next sequence number.
+     */
+    void publish(const Setpoint &setpoint) noexcept;
+
+    /**
+     * @brief Returns the newest setpoint if it has not been consumed yet. Reader side only.
+     *
+     * @param now_us Current time on the same clock as `Setpoint::timestamp_us`.
+     * @return Pointer to the setpoint, valid until the next call, or nullptr if nothing new was published.
+     */
+    const Setpoint *consume(int64_t now_us) noexcept;
+
+    /**
+     * @brief Returns a snapshot of the delivery statistics.
+     */
+    SetpointStats get_stats() const noexcept;
+
+    /**
+     * @brief Requests clearing the statistics. Applied by the reader on its next `consume()`.
+     */
+    void reset_stats() noexcept;
+
+private:
+    TripleBuffer<Setpoint> m_buffer;
+    uint32_t m_next_sequence;
+    uint32_t m_last_sequence;
+    std::atomic<uint32_t> m_received;
+    std::atomic<uint32_t> m_overwritten;
+    std::atomic<int32_t> m_last_latency_us;
+    std::atomic<int32_t> m_max_latency_us;
+    std::atomic<bool> m_reset_requested;
+};
+
+} // namespace kopter
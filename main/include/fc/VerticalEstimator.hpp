@@ -0,0 +1,118 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#pragma once
+
+#include "IMUData.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+
+namespace kopter {
+
+/**
+ * @brief Estimates altitude and vertical velocity from the accelerometer and the barometer.
+ *
+ * A third-order complementary filter: every IMU sample, the vertical acceleration in the world frame is integrated
+ * into velocity and altitude, and the error between the last barometric altitude and the estimate pulls altitude,
+ * velocity and an accelerometer bias towards the barometer. Above the crossover set by the time constant the
+ * estimate follows the accelerometer, so it leads the slow, filtered barometer; below it follows the barometer,
+ * so it does not drift. The bias state absorbs what the orientation filter leaves in the vertical axis, e.g. a
+ * small tilt error or a residual accelerometer offset.
+ *
+ * The gains are those of a critically damped third-order loop with all three poles at `-1 / time_constant`:
+ * `3 / T`, `3 / T²` and `1 / T³`, so the one parameter trades barometer noise against how fast a bias is
+ * learned.
+ *
+ * Example usage:
+ * ```
+ * VerticalEstimator estimator;
+ * estimator.predict(imu_data, orientation_filter.get_quat(), imu_data.timestamp_us); // every IMU sample
+ *
+ * // every altitude loop, only with a new conversion and a plausible pressure
+ * const float pressure = barometer.read_pressure();
+ * if (barometer.has_new_sample()) {
+ *     if (const std::optional<float> relative_altitude = altitude_reference.update(pressure)) {
+ *         estimator.correct(*relative_altitude);
+ *     }
+ * }
+ * float altitude = estimator.get_altitude();
+ * ```
+ */
+class VerticalEstimator {
+public:
+    /// Default time constant in seconds.
+    static constexpr float DEFAULT_TIME_CONSTANT_S = 1.5f;
+
+    /**
+     * @brief Ctor for an estimator that starts at the first barometric altitude.
+     *
+     * @param time_constant_s Time constant of the barometer correction in seconds.
+     */
+    explicit VerticalEstimator(float time_constant_s = DEFAULT_TIME_CONSTANT_S) noexcept;
+
+    /**
+     * @brief Integrates one IMU sample.
+     *
+     * Samples before the first barometric altitude only start the clock. A gap of more than `MAX_DT_US` is not
+     * integrated either.
+     *
+     * @param data Accelerometer reading in g.
+     * @param orientation Rotation from the body to the world frame, e.g. `ComplementaryFilter::get_quat()`.
+     * @param timestamp_us Time the sample was taken in microseconds.
+     */
+    void predict(const IMUData &data, const glm::quat &orientation, int64_t timestamp_us) noexcept;
+
+    /**
+     * @brief Takes a barometric altitude, which corrects every following prediction until the next one.
+     *
+     * Call it once per barometer conversion; passing the same conversion again weights it twice.
+     *
+     * @param altitude Barometric altitude in meters, e.g. from `AltitudeReference::update`.
+     */
+    void correct(float altitude) noexcept;
+
+    /**
+     * @brief Returns the estimated altitude in meters, on the scale of the barometric altitude.
+     */
+    float get_altitude() const noexcept;
+
+    /**
+     * @brief Returns the estimated vertical velocity in m/s, positive up.
+     */
+    float get_velocity() const noexcept;
+
+    /**
+     * @brief Returns the estimated bias of the vertical acceleration in m/s², subtracted from every sample.
+     */
+    float get_accel_bias() const noexcept;
+
+private:
+    /// Longest sample interval that is integrated.
+    static constexpr int64_t MAX_DT_US = 100000;
+
+    float m_altitude_gain;
+    float m_velocity_gain;
+    float m_bias_gain;
+    float m_altitude;
+    float m_velocity;
+    float m_accel_bias;
+    float m_baro_altitude;
+    int64_t m_last_timestamp_us;
+    bool m_initialized;
+};
+
+} // namespace kopter
@@ -0,0 +1,100 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+#include "PID.hpp"
+
+namespace kopter {
+
+/**
+ * @class CascadePID
+ * @brief Two-stage angle→rate controller for a single rotation axis.
+ *
+ * The outer (angle) PID turns the angle error into an angular rate setpoint, and the inner (rate) PID
+ * turns the rate error, measured directly by the gyroscope, into the mixer command. The inner stage
+ * reacts to disturbances before they show up as an angle error and is meant to run at the full IMU rate,
+ * while the outer stage can run slower.
+ *
+ * Typical usage:
+ * ```
+ * CascadePID roll(std::make_unique<PID>(4.0f), std::make_unique<PID>(0.002f, 0.0f, 0.05f));
+ * roll.set_target_angle(0.0f);
+ * roll.update_angle(roll_deg);          // attitude loop
+ * roll.update_rate(gyro_x_dps, output); // rate loop
+ * ```
+ */
+class CascadePID {
+public:
+    /**
+     * @brief Ctor for a cascade of two PID controllers.
+     *
+     * @param angle_pid Outer controller: angle in degrees → rate setpoint in °/s. If nullptr, a default one is used.
+     * @param rate_pid Inner controller: rate in °/s → mixer command. If nullptr, a default one is used.
+     */
+    explicit CascadePID(std::unique_ptr<PID> angle_pid = nullptr, std::unique_ptr<PID> rate_pid = nullptr);
+
+    /**
+     * @brief Runs the outer loop and updates the rate setpoint of the inner loop.
+     *
+     * @param angle Current angle in degrees.
+     *
+     * @throws PIDException if PID calculation has failed.
+     */
+    void update_angle(float angle);
+
+    /**
+     * @brief Runs the inner loop.
+     *
+     * @param rate Current angular rate in °/s.
+     * @param output Calculated command for the mixer.
+     *
+     * @throws PIDException if PID calculation has failed.
+     */
+    void update_rate(float rate, float &output);
+
+    /**
+     * @brief Sets the target angle of the outer loop.
+     *
+     * @param value Target angle in degrees.
+     */
+    void set_target_angle(float value) noexcept;
+
+    /**
+     * @brief Returns the rate setpoint produced by the last `update_angle()` call in °/s.
+     */
+    constexpr float get_rate_setpoint() const noexcept
+    {
+        return m_rate_setpoint;
+    }
+
+    /**
+     * @brief Returns the outer (angle) controller for tuning.
+     */
+    PID &get_angle_pid() noexcept;
+
+    /**
+     * @brief Returns the inner (rate) controller for tuning.
+     */
+    PID &get_rate_pid() noexcept;
+
+private:
+    std::unique_ptr<PID> m_angle_pid;
+    std::unique_ptr<PID> m_rate_pid;
+    float m_rate_setpoint;
+};
+
+} // namespace kopter
@@ -0,0 +1,113 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+namespace kopter {
+
+/**
+ * @brief Turns barometric pressure into altitude above the takeoff point for the altitude loop.
+ *
+ * Pressures outside 300..1100 hPa, the range of the BMP280, are rejected, so a failed read cannot move the zero.
+ * While disarmed, the pressures passed to `update` are averaged in blocks of `ground_samples`, and each complete
+ * block moves the zero to its mean, so the zero follows the weather on the ground. On arming the zero is frozen:
+ * the partial block is folded in if it holds at least half a block, otherwise the last complete block stands.
+ * The altitude of the zero is computed once per block; every sample then costs one table lookup and one
+ * subtraction, and the altitude loop works on small values around 0 instead of an absolute altitude that drifts
+ * with the weather.
+ *
+ * A QNH, the sea-level pressure reported by a nearby airfield, only affects `get_altitude_amsl` and
+ * `get_ground_elevation`. It may be set from any task, e.g. the radio rx task; everything else belongs to the
+ * flight loop.
+ */
+class AltitudeReference {
+public:
+    /// Default number of samples averaged into the zero, about one second at the default altitude loop rate.
+    static constexpr uint32_t DEFAULT_GROUND_SAMPLES = 16;
+
+    /**
+     * @brief Ctor for a reference without a zero, which is taken from the first sample.
+     *
+     * @param ground_samples Samples averaged into the zero; 0 is treated as 1.
+     */
+    explicit AltitudeReference(uint32_t ground_samples = DEFAULT_GROUND_SAMPLES) noexcept;
+
+    AltitudeReference(const AltitudeReference &) = delete;
+    AltitudeReference &operator=(const AltitudeReference &) = delete;
+
+    /**
+     * @brief Takes a new pressure reading.
+     *
+     * @param pressure Pressure in Pascals (Pa).
+     * @return Altitude above the zero in meters (m), or nothing if the pressure is not finite or out of range.
+     */
+    std::optional<float> update(float pressure) noexcept;
+
+    /**
+     * @brief Sets whether the vehicle is armed. Arming freezes the zero, disarming resumes averaging.
+     *
+     * Only a change of state acts, so the armed state may be passed on every call of the flight loop.
+     */
+    void set_armed(bool armed) noexcept;
+
+    /**
+     * @brief Sets the number of samples averaged into the zero and restarts the current block.
+     */
+    void set_ground_samples(uint32_t ground_samples) noexcept;
+
+    /**
+     * @brief Sets the QNH. May be called from any task; taken over by the next `update`.
+     *
+     * @param qnh_pa Sea-level pressure in Pascals (Pa).
+     */
+    void set_qnh(float qnh_pa) noexcept;
+
+    /**
+     * @brief Returns the altitude of the last sample above mean sea level for the QNH, in meters (m).
+     *
+     * Without a QNH this is the pressure altitude, above standard sea-level pressure.
+     */
+    float get_altitude_amsl() const noexcept;
+
+    /**
+     * @brief Returns the altitude of the zero above mean sea level for the QNH, in meters (m).
+     */
+    float get_ground_elevation() const noexcept;
+
+private:
+    /**
+     * @brief Moves the zero to the mean of the current block and starts a new one.
+     */
+    void fold_block() noexcept;
+
+    uint32_t m_ground_samples;
+    uint32_t m_block_count;
+    float m_block_sum;
+    float m_altitude;
+    float m_ground_altitude;
+    float m_qnh_pa;
+    float m_qnh_altitude;
+    bool m_zeroed;
+    bool m_armed;
+    std::atomic<float> m_requested_qnh_pa;
+};
+
+} // namespace kopter
@@ -71,6 +71,14 @@ struct IBarometer : public IDevice {
      * @return Altitude in meters (m).
      */
     virtual float read_altitude() = 0;
+
+    /**
+     * @brief Whether the last `read_*` call returned a conversion that no earlier call returned.
+     *
+     * Consumers that integrate samples, like the vertical estimator, skip reads without one. The default suits
+     * sensors that convert on every read.
+     */
+    virtual bool has_new_sample() const noexcept;
 };
 
 } // namespace kopter
\ No newline at end of file
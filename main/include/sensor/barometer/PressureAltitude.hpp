@@ -0,0 +1,45 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#pragma once
+
+namespace kopter {
+
+/**
+ * @brief Conversion of pressure to altitude in the standard atmosphere.
+ */
+struct PressureAltitude {
+    /// Standard sea-level pressure in Pa.
+    static constexpr float SEA_LEVEL_PRESSURE = 101325.0f;
+
+    /**
+     * @brief Returns the altitude of a pressure above standard sea-level pressure, `44330 * (1 - (p / 101325)^0.1903)`.
+     *
+     * Between 50000 and 110000 Pa (about -700 m to 5580 m) the altitude is interpolated from a table and is within
+     * 2 cm of the formula. Outside that range the formula is evaluated with `std::pow`.
+     *
+     * The altitude difference of two pressures is their height difference in the standard atmosphere, so the
+     * altitude above another reference pressure, e.g. QNH or the pressure at takeoff, is
+     * `to_altitude(p) - to_altitude(reference)`.
+     *
+     * @param pressure Pressure in Pascals (Pa).
+     * @return Altitude in meters (m).
+     */
+    static float to_altitude(float pressure) noexcept;
+};
+
+} // namespace kopter
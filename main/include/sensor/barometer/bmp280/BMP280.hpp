@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "BMP280Config.hpp"
 #include "BMP280Mapper.hpp"
 #include "I2cDevice.hpp"
 #include "IBarometer.hpp"
@@ -28,9 +29,17 @@ namespace kopter {
  * This class provides a high-level C++ interface for reading pressure,
  * temperature, and altitude from a BMP280 sensor via I2C.
  *
+ * In normal mode the sensor converts on its own, every `BMP280Config::get_conversion_period_us()`. Reads return
+ * the cached compensated values of the last conversion and only go to the bus once the next one is due, so a
+ * high-rate loop costs a few transactions per conversion. In forced mode a read that finds the conversion it
+ * started finished fetches it and starts the next one, so conversions follow the loop that reads them.
+ * `has_new_sample()` tells whether the last read returned a conversion for the first time. Until the first
+ * conversion after power-up the sensor holds the "measurement skipped" reading; such bursts are not taken as a
+ * sample and are polled again, so the reads before the first conversion return 0 and no new sample.
+ *
  * Example usage:
  * ```
- * BMP280 sensor(0x76);
+ * BMP280 sensor(0x76, BMP280Config::from_profile(BMP280Profile::STANDARD));
  * float temp = sensor.read_temperature();
  * float pressure = sensor.read_pressure();
  * float altitude = sensor.read_altitude();
@@ -42,14 +51,20 @@ public:
      * @brief Ctor for a new BMP280 object.
      *
      * @param address I2C address of the BMP280 sensor.
+     * @param config Oversampling, filter, standby time and power mode.
      */
-    explicit BMP280(uint8_t address);
+    explicit BMP280(uint8_t address, const BMP280Config &config = {});
 
     /**
      * @brief Dtor for the BMP280 object.
      */
     ~BMP280() override = default;
 
+    /**
+     * @brief Move ctor. Allows the sensor to be held by value in a `FlightPipeline`.
+     */
+    BMP280(BMP280 &&) noexcept = default;
+
     /**
      * @brief Returns the name `"[BMP280]"`.
      *
@@ -68,6 +83,9 @@ public:
     /**
      * @brief Read a pressure from the sensor.
      *
+     * Temperature and pressure are burst-read together, so the pressure is compensated with the temperature of the
+     * same conversion.
+     *
      * @return float Pressure in pascals (Pa).
      */
     float read_pressure() override;
@@ -75,20 +93,65 @@ public:
     /**
      * @brief Calculate altitude based on current pressure.
      *
-     * Uses standard sea-level pressure (101325 Pa) for altitude calculation.
+     * Uses standard sea-level pressure (101325 Pa) for altitude calculation. Takes a single burst read, as
+     * `read_pressure`.
      *
      * @return float Altitude in meters.
      */
     float read_altitude() override;
 
+    /**
+     * @brief Whether the last `read_*` call returned a conversion that no earlier call returned.
+     */
+    bool has_new_sample() const noexcept override;
+
+    /**
+     * @brief Switches the oversampling, filter, standby time and power mode, e.g. to a low-noise profile in a hover.
+     *
+     * The sensor is put to sleep while CONFIG is written, as the datasheet requires. The cached values are kept
+     * until the first conversion with the new configuration. In forced mode without any conversion read yet, i.e.
+     * from the ctor, the first conversion is started here and waited for, so the first read returns a pressure
+     * instead of the zeroed cache.
+     *
+     * @param config The new configuration.
+     */
+    void set_config(const BMP280Config &config);
+
+    /**
+     * @brief Returns the active configuration, including its measurement time and conversion period.
+     */
+    const BMP280Config &get_config() const noexcept;
+
 private:
-    void set_ctrl_meas();
-    void set_config();
+    /**
+     * @brief Refreshes the cached values if the next conversion is due.
+     *
+     * Temperature and pressure of one conversion are read in a single 6-byte burst and compensated together. A burst
+     * that still holds the cached conversion or a skipped reading is retried after a short poll interval, which also
+     * aligns later reads to the conversion cadence of the sensor.
+     */
+    void update();
+
+    /**
+     * @brief Starts a conversion in forced mode and schedules its read after the longest measurement time.
+     */
+    void start_conversion(int64_t now_us);
+
     void set_calib_data();
 
-    std::unique_ptr<I2cDevice> m_i2c_device;
+    // Impossible 20-bit readings, so the first burst is always new.
+    static constexpr BMP280RawFrame NO_READING{.temperature = -1, .pressure = UINT32_MAX};
+
+    I2cDevice *m_i2c_device{nullptr};
     std::unique_ptr<BMP280Mapper> m_mapper;
     std::unique_ptr<BMP280Calibration> m_calib;
+    BMP280Config m_config;
+    BMP280RawFrame m_raw{NO_READING};
+    BMP280Measurement m_measurement{};
+    float m_altitude{0.0f};
+    int64_t m_next_read_us{0};
+    bool m_new_sample{false};
+    bool m_conversion_pending{false};
 };
 
 } // namespace kopter
\ No newline at end of file
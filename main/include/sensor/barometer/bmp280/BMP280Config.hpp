@@ -0,0 +1,191 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+
+namespace kopter {
+
+/**
+ * @brief Oversampling of a BMP280 measurement, the values of the osrs_t and osrs_p fields of CTRL_MEAS.
+ *
+ * Each step doubles the measurement time of that quantity and lowers its noise. `SKIPPED` leaves the measurement
+ * out; the pressure cannot be compensated without the temperature.
+ */
+enum class BMP280Oversampling : uint8_t {
+    SKIPPED = 0,
+    X1 = 1,
+    X2 = 2,
+    X4 = 3,
+    X8 = 4,
+    X16 = 5
+};
+
+/**
+ * @brief Coefficient of the IIR filter of the BMP280, the values of the filter field of CONFIG.
+ *
+ * A higher coefficient suppresses short pressure disturbances (doors, prop wash) at the cost of a slower step
+ * response: it takes about 2, 5, 11 and 22 samples to reach 75 % of a step with X2, X4, X8 and X16.
+ */
+enum class BMP280Filter : uint8_t {
+    OFF = 0,
+    X2 = 1,
+    X4 = 2,
+    X8 = 3,
+    X16 = 4
+};
+
+/**
+ * @brief Standby time between conversions in normal mode, the values of the t_sb field of CONFIG.
+ */
+enum class BMP280Standby : uint8_t {
+    MS_0_5 = 0,
+    MS_62_5 = 1,
+    MS_125 = 2,
+    MS_250 = 3,
+    MS_500 = 4,
+    MS_1000 = 5,
+    MS_2000 = 6,
+    MS_4000 = 7
+};
+
+/**
+ * @brief Power mode of the BMP280, the values of the mode field of CTRL_MEAS.
+ *
+ * In `NORMAL` mode the sensor converts on its own, separated by the standby time. In `FORCED` mode it converts
+ * once when asked and then sleeps, so conversions follow the caller.
+ */
+enum class BMP280Mode : uint8_t {
+    SLEEP = 0,
+    FORCED = 1,
+    NORMAL = 3
+};
+
+/**
+ * @brief Presets of oversampling, filter and standby time after the use cases of the datasheet (section 3.8).
+ */
+enum class BMP280Profile : uint8_t {
+    /// x1 pressure and temperature, filter off, 1 s standby: lowest current, for a vehicle on the ground.
+    LOW_POWER,
+    /// x4 pressure, x1 temperature, IIR 4, 62.5 ms standby: about 13 Hz with moderate noise.
+    STANDARD,
+    /// x16 pressure, x2 temperature, IIR 16, 0.5 ms standby: the lowest noise, for holding altitude in a hover.
+    HIGH_RESOLUTION,
+    /// x2 pressure, x1 temperature, filter off, 0.5 ms standby: about 125 Hz with the least delay.
+    ULTRA_LOW_LATENCY
+};
+
+/**
+ * @brief Measurement configuration of the BMP280.
+ *
+ * Covers the registers CTRL_MEAS and CONFIG, which `BMP280` writes, and the measurement time and conversion period
+ * derived from them, which tell a scheduler how often the data registers are worth reading.
+ */
+struct BMP280Config {
+    /// Temperature oversampling. x2 and above gain nothing for the pressure.
+    BMP280Oversampling temperature_oversampling{BMP280Oversampling::X1};
+
+    /// Pressure oversampling.
+    BMP280Oversampling pressure_oversampling{BMP280Oversampling::X4};
+
+    /// IIR filter coefficient.
+    BMP280Filter filter{BMP280Filter::X4};
+
+    /// Standby time between conversions in normal mode.
+    BMP280Standby standby{BMP280Standby::MS_62_5};
+
+    /// Power mode.
+    BMP280Mode mode{BMP280Mode::NORMAL};
+
+    /**
+     * @brief Returns the configuration of a preset.
+     *
+     * @param profile The preset.
+     * @param mode `NORMAL` to convert continuously, `FORCED` to convert on every read.
+     */
+    static constexpr BMP280Config from_profile(BMP280Profile profile, BMP280Mode mode = BMP280Mode::NORMAL) noexcept
+    {
+        switch (profile) {
+        case BMP280Profile::LOW_POWER:
+            return {BMP280Oversampling::X1, BMP280Oversampling::X1, BMP280Filter::OFF, BMP280Standby::MS_1000, mode};
+        case BMP280Profile::HIGH_RESOLUTION:
+            return {BMP280Oversampling::X2, BMP280Oversampling::X16, BMP280Filter::X16, BMP280Standby::MS_0_5, mode};
+        case BMP280Profile::ULTRA_LOW_LATENCY:
+            return {BMP280Oversampling::X1, BMP280Oversampling::X2, BMP280Filter::OFF, BMP280Standby::MS_0_5, mode};
+        default:
+            return {BMP280Oversampling::X1, BMP280Oversampling::X4, BMP280Filter::X4, BMP280Standby::MS_62_5, mode};
+        }
+    }
+
+    /**
+     * @brief Returns the typical time of one conversion in microseconds (datasheet section 3.8.1).
+     */
+    constexpr int64_t get_measurement_time_us() const noexcept
+    {
+        const int64_t pressure_us = pressure_oversampling == BMP280Oversampling::SKIPPED
+                                        ? 0
+                                        : 2000 * get_samples(pressure_oversampling) + 500;
+        return 1000 + 2000 * get_samples(temperature_oversampling) + pressure_us;
+    }
+
+    /**
+     * @brief Returns the longest time of one conversion in microseconds (datasheet section 3.8.1).
+     */
+    constexpr int64_t get_max_measurement_time_us() const noexcept
+    {
+        const int64_t pressure_us = pressure_oversampling == BMP280Oversampling::SKIPPED
+                                        ? 0
+                                        : 2300 * get_samples(pressure_oversampling) + 575;
+        return 1250 + 2300 * get_samples(temperature_oversampling) + pressure_us;
+    }
+
+    /**
+     * @brief Returns the typical period of new conversions in normal mode in microseconds, the measurement time
+     * plus the standby time. In forced mode conversions follow the reads.
+     */
+    constexpr int64_t get_conversion_period_us() const noexcept
+    {
+        constexpr int64_t STANDBY_US[] = {500, 62500, 125000, 250000, 500000, 1000000, 2000000, 4000000};
+        return get_measurement_time_us() + STANDBY_US[static_cast<uint8_t>(standby)];
+    }
+
+    /**
+     * @brief Returns the value of CTRL_MEAS.
+     */
+    constexpr uint8_t get_ctrl_meas() const noexcept
+    {
+        return static_cast<uint8_t>(static_cast<uint8_t>(temperature_oversampling) << 5 |
+                                    static_cast<uint8_t>(pressure_oversampling) << 2 | static_cast<uint8_t>(mode));
+    }
+
+    /**
+     * @brief Returns the value of CONFIG, with the 3-wire SPI interface off.
+     */
+    constexpr uint8_t get_config() const noexcept
+    {
+        return static_cast<uint8_t>(static_cast<uint8_t>(standby) << 5 | static_cast<uint8_t>(filter) << 2);
+    }
+
+private:
+    static constexpr int64_t get_samples(BMP280Oversampling oversampling) noexcept
+    {
+        return oversampling == BMP280Oversampling::SKIPPED ? 0 : int64_t{1} << (static_cast<uint8_t>(oversampling) - 1);
+    }
+};
+
+} // namespace kopter
@@ -20,6 +20,24 @@
 
 namespace kopter {
 
+/**
+ * @brief Raw temperature and pressure of one BMP280 conversion, as burst-read from 0xF7..0xFC.
+ */
+struct BMP280RawFrame {
+    int32_t temperature;
+    uint32_t pressure;
+
+    bool operator==(const BMP280RawFrame &) const = default;
+};
+
+/**
+ * @brief Compensated temperature and pressure of one BMP280 conversion.
+ */
+struct BMP280Measurement {
+    float temperature; // °C
+    float pressure;    // Pa
+};
+
 /**
  * @brief Mapper for BMP280 readings.
  */
@@ -49,10 +67,23 @@ public:
     float map_pressure(uint32_t raw, BMP280Calibration *calib);
 
     /**
-     * @brief Maps the calculated pressure value into altitude.
+     * @brief Maps the temperature and pressure of one conversion.
      *
-     * @param raw 32-bit unsigned raw value from the sensor.
-     * @return Transformed pressure in Pascals (Pa).
+     * The temperature is compensated first, so the pressure uses the fine temperature of the same conversion.
+     *
+     * @param raw Raw values from the sensor.
+     * @param calib Pointer to the BMP280 calibration data.
+     * @return Temperature in degrees Celsius and pressure in Pascals (Pa).
+     */
+    BMP280Measurement map(const BMP280RawFrame &raw, BMP280Calibration *calib);
+
+    /**
+     * @brief Maps the calculated pressure value into altitude above standard sea-level pressure.
+     *
+     * See `PressureAltitude::to_altitude` for the accuracy.
+     *
+     * @param pressure Pressure in Pascals (Pa).
+     * @return Altitude in meters (m).
      */
     float map_altitude(float pressure);
 
@@ -0,0 +1,118 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#pragma once
+
+#include "IMU.hpp"
+
+#include <array>
+#include <glm/vec3.hpp>
+
+namespace kopter {
+
+/**
+ * @brief Resting orientations of the six-position accelerometer calibration, in the order they are captured.
+ */
+enum class AccelOrientation : uint8_t {
+    Z_UP,
+    Z_DOWN,
+    X_UP,
+    X_DOWN,
+    Y_UP,
+    Y_DOWN
+};
+
+/**
+ * @brief Settings of `AccelCalibration`.
+ */
+struct AccelCalibrationConfig {
+    /// Samples averaged per orientation.
+    uint32_t samples = 200;
+
+    /// Largest standard deviation of any axis within a window at rest, in g.
+    float max_noise_g = 0.02f;
+
+    /// Smallest reading of the axis pointing up (or down) for a window to count as that orientation, in g.
+    float min_alignment_g = 0.8f;
+
+    /// Windows tried per orientation before giving up; at the default 100 Hz FreeRTOS tick about a minute.
+    uint32_t max_attempts = 30;
+
+    /// Time between samples in microseconds, i.e. the sample period of the IMU, see `SamplePacer`; 0 reads back to
+    /// back.
+    int64_t sample_period_us = 1000;
+
+    /// Pause after a rejected window, which lets lower priority tasks run while the board is being turned.
+    uint32_t retry_delay_ms = 100;
+};
+
+/**
+ * @brief Guided six-position calibration of an accelerometer.
+ *
+ * The board is rested in turn with each axis pointing up and down, see `AccelOrientation`. For each orientation the
+ * calibration logs an instruction and waits for a window at rest whose dominant axis matches, so the operator
+ * only has to turn the board; nothing has to be confirmed.
+ *
+ * The six mean readings `m` and the gravity vectors `g` they should have read give 18 equations for the 12 unknowns
+ * of the affine correction `g = M * m + c`: per-axis scale and cross-axis misalignment in `M`, offset in `c`. They
+ * are solved by linear least squares, see `solve()`.
+ *
+ * The windows are paced by `SamplePacer`, so waiting for the operator sleeps instead of starving other tasks.
+ */
+class AccelCalibration {
+public:
+    static constexpr size_t ORIENTATION_COUNT = 6;
+
+    /**
+     * @brief Ctor for a calibration with the given settings.
+     */
+    explicit AccelCalibration(const AccelCalibrationConfig &config = {});
+
+    /**
+     * @brief Captures all six orientations, solves for the correction and applies it with
+     * `IMU::set_accel_correction`.
+     *
+     * @param imu The IMU to calibrate. Its correction is cleared first and kept cleared on failure.
+     * @return The applied correction, or nothing if an orientation timed out or the readings were degenerate.
+     *
+     * @throws I2cException or any other exception of `IMU::get_data`.
+     */
+    std::optional<AccelCorrection> run(IMU &imu);
+
+    /**
+     * @brief Solves for the affine correction mapping the readings to the gravity vectors of their orientations.
+     *
+     * @param measured Mean readings in g, indexed by `AccelOrientation`.
+     * @return The least-squares correction, or nothing if the readings do not span all three axes.
+     */
+    static std::optional<AccelCorrection> solve(const std::array<glm::vec3, ORIENTATION_COUNT> &measured);
+
+    /**
+     * @brief Returns the specific force an ideal accelerometer reads at rest in an orientation, in g.
+     */
+    static glm::vec3 get_expected(AccelOrientation orientation) noexcept;
+
+private:
+    /**
+     * @brief Waits until the board rests in `orientation` and returns the mean reading.
+     */
+    std::optional<glm::vec3> capture(IMU &imu, AccelOrientation orientation);
+
+    AccelCalibrationConfig m_config;
+};
+
+} // namespace kopter
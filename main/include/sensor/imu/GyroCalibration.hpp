@@ -0,0 +1,145 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#pragma once
+
+#include "IMU.hpp"
+
+namespace kopter {
+
+/**
+ * @brief Where the bias applied by `GyroCalibration::run` came from.
+ */
+enum class GyroCalibrationSource : uint8_t {
+    /// Averaged over a full window at rest; worth storing.
+    CALIBRATED,
+
+    /// The stored bias, confirmed by a short window at rest and a similar temperature.
+    WARM_START,
+
+    /// The stored bias, unconfirmed because the board kept moving.
+    STORED_FALLBACK,
+
+    /// No bias: the board kept moving and none was stored.
+    NONE
+};
+
+/**
+ * @brief Settings of `GyroCalibration`.
+ */
+struct GyroCalibrationConfig {
+    /// Samples averaged by a full calibration.
+    uint32_t samples = 500;
+
+    /// Samples of the window confirming a stored bias; 0 disables the warm start.
+    uint32_t warm_start_samples = 100;
+
+    /// Full windows tried before giving up on a moving board.
+    uint32_t max_attempts = 3;
+
+    /// Largest standard deviation of any axis within a window at rest, in °/s.
+    float max_noise_dps = 0.5f;
+
+    /// Largest difference of any axis between a stored bias and the warm start window mean, in °/s.
+    float warm_start_tolerance_dps = 0.3f;
+
+    /// Largest die temperature difference at which a stored bias is still trusted, in degrees Celsius.
+    float warm_start_max_temperature_delta = 5.0f;
+
+    /// Time between samples in microseconds, i.e. the sample period of the IMU, see `SamplePacer`; 0 reads back to
+    /// back.
+    int64_t sample_period_us = 1000;
+};
+
+/**
+ * @brief Outcome of `GyroCalibration::run`.
+ */
+struct GyroCalibrationResult {
+    /// Bias applied to the IMU.
+    GyroBias bias;
+
+    /// Where `bias` came from.
+    GyroCalibrationSource source;
+
+    /// Largest per-axis standard deviation of the last window, in °/s.
+    float noise_dps;
+
+    /// Samples read in total.
+    uint32_t sample_count;
+};
+
+/**
+ * @brief Estimates the zero-rate offset of a gyroscope at rest and applies it to the IMU.
+ *
+ * A full calibration averages `GyroCalibrationConfig::samples` readings. Any axis scattering more than
+ * `max_noise_dps` means the board was moved, so the window is discarded and taken again.
+ *
+ * With a bias stored by an earlier boot (see `FirmwareService::get_gyro_bias`), a short window comes first. If the
+ * board is at rest, its mean agrees with the stored bias and the die temperature is close to the stored one, the
+ * stored bias is applied right away, which cuts the time to arm to the short window. The stored bias averaged more
+ * samples, so it is also the more accurate of the two.
+ *
+ * Runs once before the control loop starts, on the task creating the sensors. It sleeps between samples, see
+ * `SamplePacer`, so at the default 100 Hz FreeRTOS tick a window takes one tick per sample.
+ */
+class GyroCalibration {
+public:
+    /**
+     * @brief Ctor for a calibration with the given settings.
+     */
+    explicit GyroCalibration(const GyroCalibrationConfig &config = {});
+
+    /**
+     * @brief Determines the gyroscope bias and applies it with `IMU::set_gyro_bias`.
+     *
+     * If the board does not come to rest within `max_attempts` windows, the stored bias is applied if there is one,
+     * and no bias otherwise.
+     *
+     * @param imu The IMU to calibrate. Its bias is cleared first.
+     * @param stored Bias stored by an earlier boot, if any.
+     * @return The applied bias and where it came from. Only `GyroCalibrationSource::CALIBRATED` is worth storing.
+     *
+     * @throws I2cException or any other exception of `IMU::get_data`.
+     */
+    GyroCalibrationResult run(IMU &imu, const std::optional<GyroBias> &stored);
+
+private:
+    /// Mean and largest per-axis standard deviation of a window.
+    struct Window {
+        GyroBias mean;
+        float noise_dps;
+    };
+
+    /**
+     * @brief Reads `count` samples, one per sample period.
+     */
+    Window sample(IMU &imu, uint32_t count);
+
+    /**
+     * @brief Whether a window was taken at rest.
+     */
+    bool is_still(const Window &window) const noexcept;
+
+    /**
+     * @brief Whether a window at rest confirms a stored bias.
+     */
+    bool confirms(const Window &window, const GyroBias &stored) const noexcept;
+
+    GyroCalibrationConfig m_config;
+};
+
+} // namespace kopter
@@ -19,6 +19,8 @@
 #include "IDevice.hpp"
 #include "IMUData.hpp"
 
+#include <span>
+
 namespace kopter {
 
 /**
@@ -30,6 +32,9 @@ namespace kopter {
  * (e.g., MPU6050) that handle actual communication with hardware.
  */
 struct IMU : public IDevice {
+    /// Largest batch `read_batch` is expected to fill; callers size their buffers with it.
+    static constexpr size_t MAX_BATCH = 8;
+
     /**
      * @brief Ctor an IMU device.
      */
@@ -54,6 +59,33 @@ struct IMU : public IDevice {
      * @return An instance of IMUData containing accelerometer and gyroscope values.
      */
     virtual IMUData get_data() = 0;
+
+    /**
+     * @brief Reads every sample taken since the previous call, oldest first.
+     *
+     * IMUs buffering samples on chip (e.g. the MPU6050 FIFO) return all of them, so none is lost when the sensor
+     * runs faster than the caller; samples that do not fit into `samples` are kept for the next call. The default
+     * implementation returns the single sample of `get_data()`.
+     *
+     * @param samples Buffer receiving the samples.
+     * @return The number of samples written, 0 if no new sample is available yet.
+     */
+    virtual size_t read_batch(std::span<IMUData> samples);
+
+    /**
+     * @brief Sets the gyroscope offset subtracted from every sample returned afterwards, see `GyroCalibration`.
+     *
+     * @param bias Offset in °/s; a zero bias returns the uncorrected rates.
+     */
+    virtual void set_gyro_bias(const GyroBias &bias) noexcept = 0;
+
+    /**
+     * @brief Sets the affine correction applied to every accelerometer sample returned afterwards, see
+     * `AccelCalibration`.
+     *
+     * @param correction Correction of the accelerations in g; the default one returns the uncorrected values.
+     */
+    virtual void set_accel_correction(const AccelCorrection &correction) noexcept = 0;
 };
 
 } // namespace kopter
\ No newline at end of file
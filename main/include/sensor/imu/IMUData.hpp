@@ -42,5 +42,42 @@ struct IMUData {
 
     /// Acceleration along Z axis.
     float az;
+
+    /// Die temperature in degrees Celsius, 0 if the IMU does not report it.
+    float temperature = 0.0f;
+
+    /// Time the sample was taken, in microseconds on the esp_timer clock; 0 if the IMU does not know it.
+    int64_t timestamp_us = 0;
+};
+
+/**
+ * @brief Zero-rate offset of a gyroscope, subtracted from every sample by the IMU, see `IMU::set_gyro_bias`.
+ */
+struct GyroBias {
+    /// Offset around X axis in °/s.
+    float gx = 0.0f;
+
+    /// Offset around Y axis in °/s.
+    float gy = 0.0f;
+
+    /// Offset around Z axis in °/s.
+    float gz = 0.0f;
+
+    /// Die temperature the offset was measured at, in degrees Celsius.
+    float temperature = 0.0f;
+};
+
+/**
+ * @brief Affine correction of an accelerometer: `corrected = matrix * measured + offset`, see `AccelCalibration`.
+ *
+ * The matrix holds the per-axis scale on its diagonal and the cross-axis misalignment off it; the default is the
+ * identity, i.e. no correction.
+ */
+struct AccelCorrection {
+    /// Scale and misalignment, row-major.
+    float matrix[3][3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+
+    /// Offset in g, added after the matrix.
+    float offset[3] = {0.0f, 0.0f, 0.0f};
 };
 } // namespace kopter
\ No newline at end of file
@@ -0,0 +1,81 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#pragma once
+
+#include "freertos/task.h"
+
+#include <algorithm>
+
+namespace kopter {
+
+/**
+ * @brief Paces a loop reading an IMU by sleeping until the next sample is due.
+ *
+ * Sleeps with `vTaskDelayUntil` instead of spinning, so lower priority tasks, the idle task among them, keep running
+ * and the task watchdog stays fed. The period is rounded up to whole FreeRTOS ticks, at least one: at a tick rate
+ * below the sample rate of the IMU the loop reads every few samples of the sensor instead of each one, but never
+ * the same sample twice.
+ *
+ * Example usage:
+ * ```
+ * SamplePacer pacer(config.get_sample_period_us());
+ * for (uint32_t i = 0; i != count; ++i) {
+ *     pacer.wait();
+ *     const IMUData data = imu.get_data();
+ * }
+ * ```
+ */
+class SamplePacer {
+public:
+    /**
+     * @brief Ctor for a pacer whose first period starts now.
+     *
+     * @param sample_period_us Sample period of the IMU in microseconds; 0 or less disables pacing.
+     */
+    explicit SamplePacer(int64_t sample_period_us) noexcept
+        : m_period_ticks{sample_period_us > 0
+                             ? std::max<TickType_t>(1, (sample_period_us * configTICK_RATE_HZ + 999999) / 1000000)
+                             : 0},
+          m_last_wake{xTaskGetTickCount()}
+    {
+    }
+
+    /**
+     * @brief Blocks until one period after the previous wake-up, or returns at once if pacing is disabled.
+     */
+    void wait() noexcept
+    {
+        if (m_period_ticks != 0) {
+            vTaskDelayUntil(&m_last_wake, m_period_ticks);
+        }
+    }
+
+    /**
+     * @brief Returns the period in FreeRTOS ticks, 0 if pacing is disabled.
+     */
+    TickType_t get_period_ticks() const noexcept
+    {
+        return m_period_ticks;
+    }
+
+private:
+    TickType_t m_period_ticks;
+    TickType_t m_last_wake;
+};
+
+} // namespace kopter
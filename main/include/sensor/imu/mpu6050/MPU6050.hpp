@@ -18,37 +18,61 @@
 
 #include "I2cDevice.hpp"
 #include "IMU.hpp"
-#include "MPU6050Mapper.hpp"
+#include "MPU6050Config.hpp"
+
+#include "driver/gpio.h"
+#include "esp_attr.h"
 
 namespace kopter {
 
 /**
  * @brief Represents an MPU6050 IMU sensor connected over I2C.
  *
- * This class provides access to raw accelerometer and gyroscope data
+ * This class provides access to raw accelerometer, gyroscope and die temperature data
  * from the MPU6050 sensor. It uses an I2cDevice to communicate with the
  * hardware and an IIMUValueMapper to convert raw sensor values into
  * physical units (e.g., g-forces and degrees per second).
  *
  * The sensor is initialized by writing to the power management register
- * to wake it up from sleep mode.
+ * to wake it up from sleep mode. Its full-scale ranges, low-pass filter and sample rate are set from an
+ * `MPU6050Config` in one burst, and the mapper always uses the scale factors of the configured ranges.
+ *
+ * By default every `get_data()` / `read_batch()` call reads the data registers once. After `enable_fifo()` the
+ * sensor samples at its own rate into the on-chip FIFO and `read_batch()` drains all buffered samples in one
+ * burst, with timestamps reconstructed from the sample period.
+ *
+ * After `enable_data_ready_interrupt()` the INT pin of the sensor raises a GPIO interrupt for every new sample.
+ * The interrupt handler timestamps the edge with `esp_timer` and calls an optional callback, e.g.
+ * `ControlLoop::trigger_from_isr`, so acquisition runs in step with the sensor instead of at arbitrary times,
+ * and every returned `IMUData` carries the time the sample was taken.
  */
 class MPU6050 : public IMU {
 public:
     /**
-     * @brief Ctor for a MPU6050 with the default value mapper.
+     * @brief Called from the data-ready interrupt handler after the edge was timestamped. Must be in IRAM.
+     */
+    using DataReadyCallback = void (*)(void *context);
+
+    /**
+     * @brief Ctor for a MPU6050 with the value mapper matching `config`.
      *
      * @param address The I2C address of the MPU6050 sensor.
+     * @param config Measurement configuration, see `set_config()`.
      *
      * @throws I2cException with the corrsponding esp_err_t return value if something goes wrong
      */
-    explicit MPU6050(uint8_t address);
+    explicit MPU6050(uint8_t address, const MPU6050Config &config = {});
 
     /**
-     * @brief Default dtor.
+     * @brief Dtor. Removes the data-ready interrupt handler, if any.
      */
     ~MPU6050();
 
+    /**
+     * @brief Move ctor. Allows the sensor to be held by value in a `FlightPipeline`.
+     */
+    MPU6050(MPU6050 &&) noexcept = default;
+
     /**
      * @brief Returns the `"[MPU6050]"`.
      *
@@ -60,87 +84,150 @@ public:
     /**
      * @brief Reads and returns sensor data.
      *
-     * @return An instance of IMUData with mapped acceleration and angular velocity.
+     * Reads the accelerometer, temperature and gyroscope registers (0x3B–0x48) in one burst, so all axes come
+     * from the same sample.
+     *
+     * @return An instance of IMUData with mapped acceleration, angular velocity and die temperature, stamped with
+     *         the last data-ready edge if the interrupt is enabled and with the time of the read otherwise.
+     *
+     * @throws I2cException with the corrsponding esp_err_t return value if something goes wrong
      */
     IMUData get_data() override;
 
-private:
     /**
-     * @brief Reads the acceleration value along the X axis.
-     * @return Acceleration in g.
+     * @brief Drains the samples buffered in the FIFO, oldest first.
+     *
+     * Without `enable_fifo()` this returns the single sample of `get_data()`. In FIFO mode it costs two bus
+     * transactions however many samples are returned: the FIFO count and one burst of all frames that fit into
+     * `samples`. The newest sample is timestamped with the last data-ready edge, or without the interrupt with the
+     * time of the count read, and every older one one sample period earlier. Without the interrupt this is
+     * accurate to one sample period plus the bus latency.
+     *
+     * If the FIFO overflowed, its contents are discarded, the FIFO is reset and 0 is returned.
+     *
+     * @param samples Buffer receiving the samples; at most `IMU::MAX_BATCH` are returned per call.
+     * @return The number of samples written.
      *
      * @throws I2cException with the corrsponding esp_err_t return value if something goes wrong
      */
-    float read_ax() const;
+    size_t read_batch(std::span<IMUData> samples) override;
 
     /**
-     * @brief Reads the acceleration value along the Y axis.
-     * @return Acceleration in g.
-     *
-     * @throws I2cException with the corrsponding esp_err_t return value if something goes wrong
+     * @brief Sets the gyroscope offset, which the mapper subtracts from every sample. Kept across `set_config()`.
      */
-    float read_ay() const;
+    void set_gyro_bias(const GyroBias &bias) noexcept override;
 
     /**
-     * @brief Reads the acceleration value along the Z axis.
-     * @return Acceleration in g.
-     *
-     * @throws I2cException with the corrsponding esp_err_t return value if something goes wrong
+     * @brief Sets the accelerometer correction, which the mapper fuses with the sensitivity. Kept across
+     * `set_config()`.
      */
-    float read_az() const;
+    void set_accel_correction(const AccelCorrection &correction) noexcept override;
 
     /**
-     * @brief Reads the gyroscope value around the X axis.
-     * @return Angular velocity in degrees per second.
+     * @brief Applies a measurement configuration.
+     *
+     * Writes SMPLRT_DIV, CONFIG, GYRO_CONFIG and ACCEL_CONFIG in one burst and switches the mapper to the scale
+     * factors of the new ranges. Samples buffered in the FIFO were taken with the old ranges, so it is reset.
+     *
+     * @param config The configuration to apply.
      *
      * @throws I2cException with the corrsponding esp_err_t return value if something goes wrong
      */
-    float read_gx() const;
+    void set_config(const MPU6050Config &config);
 
     /**
-     * @brief Reads the gyroscope value around the Y axis.
-     * @return Angular velocity in degrees per second.
-     *
-     * @throws I2cException with the corrsponding esp_err_t return value if something goes wrong
+     * @brief Returns the applied measurement configuration.
      */
-    float read_gy() const;
+    const MPU6050Config &get_config() const noexcept;
 
     /**
-     * @brief Reads the gyroscope value around the Z axis.
-     * @return Angular velocity in degrees per second.
+     * @brief Starts sampling into the on-chip FIFO.
+     *
+     * The accelerometer, temperature and gyroscope are sampled at the rate of the configuration.
      *
      * @throws I2cException with the corrsponding esp_err_t return value if something goes wrong
      */
-    float read_gz() const;
+    void enable_fifo();
+
+    /**
+     * @brief Returns the number of FIFO overflows since start.
+     */
+    uint32_t get_fifo_overflows() const noexcept;
 
     /**
-     * @brief Reads raw 16-bit sensor data from the specified register.
+     * @brief Enables the data-ready interrupt of the sensor on a GPIO.
      *
-     * This function reads two consecutive bytes starting from the given register address
-     * over I2C and combines them into a signed 16-bit integer. This raw value is typically
-     * used for internal conversion into physical units (e.g., acceleration or rotation rate).
+     * Configures the INT pin for a 50 µs high pulse per sample, at the rate of the configuration, and installs a
+     * rising-edge handler on `pin`.
      *
-     * @param reg The starting register address to read from.
-     * @return `int16_t` The raw 16-bit signed value from the sensor.
+     * @param pin GPIO connected to the INT pin of the sensor.
+     * @param callback Called from the interrupt handler on every edge, or `nullptr`.
+     * @param context Passed to `callback` as is.
      *
-     * @throws I2cException with the corrsponding esp_err_t return value if something goes wrong
+     * @throws I2cException with the corrsponding esp_err_t return value if the sensor cannot be configured
+     * @throws KopterException if the GPIO or its interrupt cannot be configured
+     */
+    void enable_data_ready_interrupt(gpio_num_t pin, DataReadyCallback callback = nullptr, void *context = nullptr);
+
+    /**
+     * @brief Returns the number of data-ready edges since the interrupt was enabled.
      */
-    int16_t get_raw_value(uint8_t reg) const;
+    uint32_t get_data_ready_count() const noexcept;
 
+private:
     /**
-     * @brief Sets config for device.
+     * @brief Resets the device and disables sleep mode.
      *
-     * Resets the device and disables sleep mode. Also sets the default sensitivity for the accelerometer and gyroscope.
+     * @throws I2cException with the corrsponding esp_err_t return value if something goes wrong
+     */
+    void reset();
+
+    /**
+     * @brief Clears the FIFO and restarts sampling into it.
      *
      * @throws I2cException with the corrsponding esp_err_t return value if something goes wrong
      */
-    void set_config();
+    void reset_fifo();
+
+    /**
+     * @brief Returns the time of the last data-ready edge, or `fallback_us` without the interrupt.
+     */
+    int64_t get_sample_time(int64_t fallback_us) const noexcept;
+
+    /// State shared with the data-ready interrupt handler. Held by pointer, so it stays put when the sensor moves.
+    struct DataReadyState {
+        gpio_num_t pin{GPIO_NUM_NC};
+        DataReadyCallback callback{nullptr};
+        void *context{nullptr};
+        mutable portMUX_TYPE lock;
+        int64_t timestamp_us{0};
+        uint32_t count{0};
+    };
+
+    /**
+     * @brief GPIO interrupt handler of the data-ready line.
+     *
+     * @param arg The `DataReadyState`.
+     */
+    static void IRAM_ATTR on_data_ready(void *arg);
 
-    /// I2C communication interface for MPU6050.
-    std::unique_ptr<I2cDevice> m_i2c_device;
+    /// I2C communication interface for MPU6050, owned by `I2cDeviceHolder`.
+    I2cDevice *m_i2c_device{nullptr};
 
-    /// Mapper to convert raw sensor values to physical units.
+    /// Mapper to convert raw sensor values to physical units, matching `m_config`.
     std::unique_ptr<MPU6050Mapper> m_mapper;
+
+    /// Applied measurement configuration.
+    MPU6050Config m_config;
+
+    /// Whether samples are read through the FIFO.
+    bool m_fifo_enabled{false};
+
+    /// Number of FIFO overflows.
+    uint32_t m_fifo_overflows{0};
+
+    /// Data-ready interrupt state, `nullptr` while the interrupt is disabled.
+    std::unique_ptr<DataReadyState> m_data_ready;
 };
 
 } // namespace kopter
\ No newline at end of file
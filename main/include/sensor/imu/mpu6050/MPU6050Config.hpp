@@ -0,0 +1,78 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#pragma once
+
+#include "MPU6050Mapper.hpp"
+
+namespace kopter {
+
+/**
+ * @brief Bandwidth of the digital low-pass filter of the MPU6050, named after its gyroscope bandwidth.
+ *
+ * The values are those of the DLPF_CFG field of CONFIG. A narrower filter lowers the noise at the cost of
+ * delay: from about 1 ms at `HZ_256` to about 19 ms at `HZ_5`. With `HZ_256` the filter is off and the gyroscope
+ * is sampled internally at 8 kHz instead of 1 kHz; the accelerometer always is at 1 kHz.
+ */
+enum class DlpfBandwidth : uint8_t {
+    HZ_256 = 0,
+    HZ_188 = 1,
+    HZ_98 = 2,
+    HZ_42 = 3,
+    HZ_20 = 4,
+    HZ_10 = 5,
+    HZ_5 = 6
+};
+
+/**
+ * @brief Measurement configuration of the MPU6050.
+ *
+ * Covers the four contiguous registers SMPLRT_DIV, CONFIG, GYRO_CONFIG and ACCEL_CONFIG, which `MPU6050` writes
+ * in one burst, and from which it derives the scale factors of its mapper and its sample period.
+ */
+struct MPU6050Config {
+    /// Accelerometer full-scale range.
+    AccelSensitivityMode accel_range{AccelSensitivityMode::A2G};
+
+    /// Gyroscope full-scale range. Aggressive flight needs more than ±250°/s.
+    GyroSensitivityMode gyro_range{GyroSensitivityMode::DPS_250};
+
+    /// Digital low-pass filter bandwidth.
+    DlpfBandwidth dlpf{DlpfBandwidth::HZ_188};
+
+    /// Value of SMPLRT_DIV: the sample rate is the internal rate / (1 + divider).
+    uint8_t sample_rate_divider{0};
+
+    /**
+     * @brief Returns the period of new samples in the data registers and the FIFO, in microseconds.
+     */
+    constexpr int64_t get_sample_period_us() const noexcept
+    {
+        const int64_t internal_period_us = dlpf == DlpfBandwidth::HZ_256 ? 125 : 1000;
+        return internal_period_us * (1 + sample_rate_divider);
+    }
+
+    /**
+     * @brief Returns the sample rate in Hz, rounded down.
+     */
+    constexpr uint32_t get_sample_rate_hz() const noexcept
+    {
+        return static_cast<uint32_t>(1000000 / get_sample_period_us());
+    }
+};
+
+} // namespace kopter
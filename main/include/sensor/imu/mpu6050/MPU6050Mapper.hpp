@@ -16,126 +16,220 @@
 
 #pragma once
 
+#include "IMUData.hpp"
+
 namespace kopter {
 
 /**
  * @brief Represents accelerometer sensitivity settings for the MPU6050.
  *
  * The higher the G-force range, the less sensitive the readings (but more tolerant to higher accelerations).
+ * The values are those of the AFS_SEL field of ACCEL_CONFIG.
  */
-enum class AccelSensitivityMode {
-    A2G,
-    A4G,
-    A8G,
-    A16G
+enum class AccelSensitivityMode : uint8_t {
+    A2G = 0,
+    A4G = 1,
+    A8G = 2,
+    A16G = 3
 };
 
 /**
  * @brief Represents gyroscope sensitivity settings for the MPU6050.
  *
  * Typically maps to angular velocity ranges like ±250, ±500, ±1000, and ±2000 degrees/second.
+ * The values are those of the FS_SEL field of GYRO_CONFIG.
  */
-enum class GyroSensitivityMode {
-    DPS_250,
-    DPS_500,
-    DPS_1000,
-    DPS_2000
+enum class GyroSensitivityMode : uint8_t {
+    DPS_250 = 0,
+    DPS_500 = 1,
+    DPS_1000 = 2,
+    DPS_2000 = 3
+};
+
+/**
+ * @brief Raw sample of the MPU6050 as read from its data registers or FIFO.
+ */
+struct MPU6050RawFrame {
+    int16_t ax;
+    int16_t ay;
+    int16_t az;
+    int16_t temperature;
+    int16_t gx;
+    int16_t gy;
+    int16_t gz;
 };
 
 /**
  * @brief Provides default conversion of raw IMU data to physical units for the MPU6050 sensor.
  *
- * This class provides default conversions for raw accelerometer and gyroscope values retrieved from the MPU6050 sensor.
- * These conversions typically depend on the sensor's sensitivity settings (not shown here),
- * but the implementation assumes default sensitivity modes unless extended.
+ * This class provides conversions for raw accelerometer and gyroscope values retrieved from the MPU6050 sensor.
+ * The scale factors follow the full-scale ranges the sensor is configured with, which apply to all three axes
+ * of the accelerometer and of the gyroscope alike; `MPU6050` creates its mapper from its `MPU6050Config`.
  *
  * The mapping functions convert 16-bit signed raw sensor data into floating-point values
  * representing either acceleration (in g) or angular velocity (in degrees per second).
+ *
+ * The reciprocals of the sensitivities are computed once at construction, so mapping is one multiply instead of a
+ * divide per value and never branches. On the host it is no faster than dividing, see `kopter_i2c_bench`; it has
+ * not been measured on the ESP32. Everything is `constexpr` and inline, so a mapper for fixed ranges folds into
+ * constants. The gyroscope bias is subtracted right after the multiplication.
+ *
+ * The accelerometer correction of `AccelCalibration` is fused with the sensitivity into one affine transform of
+ * the raw vector, so a calibrated sample costs nine multiplications and nine additions for all three axes, and an
+ * uncalibrated one the same.
  */
 class MPU6050Mapper {
 public:
     /**
-     * @brief Ctor with configurable sensitivity for each axis.
+     * @brief Ctor with the full-scale ranges of the sensor.
      *
-     * @param ax_mode Sensitivity for accelerometer X axis (default: A2G)
-     * @param ay_mode Sensitivity for accelerometer Y axis (default: A2G)
-     * @param az_mode Sensitivity for accelerometer Z axis (default: A2G)
-     * @param gx_mode Sensitivity for gyroscope X axis (default: DPS_250 = ±250°/s)
-     * @param gy_mode Sensitivity for gyroscope Y axis (default: DPS_250 = ±250°/s)
-     * @param gz_mode Sensitivity for gyroscope Z axis (default: DPS_250 = ±250°/s)
+     * @param accel_mode Accelerometer range (default: A2G = ±2 g)
+     * @param gyro_mode Gyroscope range (default: DPS_250 = ±250°/s)
      */
-    explicit MPU6050Mapper(AccelSensitivityMode ax_mode = AccelSensitivityMode::A2G,
-                           AccelSensitivityMode ay_mode = AccelSensitivityMode::A2G,
-                           AccelSensitivityMode az_mode = AccelSensitivityMode::A2G,
-                           GyroSensitivityMode gx_mode = GyroSensitivityMode::DPS_250,
-                           GyroSensitivityMode gy_mode = GyroSensitivityMode::DPS_250,
-                           GyroSensitivityMode gz_mode = GyroSensitivityMode::DPS_250) noexcept;
+    constexpr explicit MPU6050Mapper(AccelSensitivityMode accel_mode = AccelSensitivityMode::A2G,
+                                     GyroSensitivityMode gyro_mode = GyroSensitivityMode::DPS_250) noexcept
+        : m_accel_scale{1.0f / ACCEL_LSB_PER_G[static_cast<uint8_t>(accel_mode)]},
+          m_gyro_scale{1.0f / GYRO_LSB_PER_DPS[static_cast<uint8_t>(gyro_mode)]}
+    {
+        fuse_accel_transform();
+    }
 
     /**
-     * @brief Maps raw X-axis accelerometer value to acceleration in g.
-     * @param raw Raw 16-bit value from sensor.
-     * @return Acceleration in g.
+     * @brief Sets the affine correction applied to every mapped acceleration.
+     * @param correction Correction of the accelerations in g.
      */
-    float map_accel_x(int16_t raw) const;
+    constexpr void set_accel_correction(const AccelCorrection &correction) noexcept
+    {
+        m_accel_correction = correction;
+        fuse_accel_transform();
+    }
 
     /**
-     * @brief Maps raw Y-axis accelerometer value to acceleration in g.
-     * @param raw Raw 16-bit value from sensor.
-     * @return Acceleration in g.
+     * @brief Returns the affine correction applied to every mapped acceleration.
      */
-    float map_accel_y(int16_t raw) const;
+    constexpr const AccelCorrection &get_accel_correction() const noexcept
+    {
+        return m_accel_correction;
+    }
 
     /**
-     * @brief Maps raw Z-axis accelerometer value to acceleration in g.
-     * @param raw Raw 16-bit value from sensor.
-     * @return Acceleration in g.
+     * @brief Sets the gyroscope offset subtracted from every mapped angular velocity.
+     * @param bias Offset in °/s.
+     */
+    constexpr void set_gyro_bias(const GyroBias &bias) noexcept
+    {
+        m_gyro_bias = bias;
+    }
+
+    /**
+     * @brief Returns the gyroscope offset subtracted from every mapped angular velocity.
+     */
+    constexpr const GyroBias &get_gyro_bias() const noexcept
+    {
+        return m_gyro_bias;
+    }
+
+    /**
+     * @brief Maps a whole raw frame.
+     * @param raw Raw frame from sensor.
+     * @return Acceleration in g, angular velocity in °/s and temperature in °C; the timestamp is left at 0.
      */
-    float map_accel_z(int16_t raw) const;
+    constexpr IMUData map(const MPU6050RawFrame &raw) const noexcept
+    {
+        return {.gx = map_gyro_x(raw.gx),
+                .gy = map_gyro_y(raw.gy),
+                .gz = map_gyro_z(raw.gz),
+                .ax = map_accel(0, raw),
+                .ay = map_accel(1, raw),
+                .az = map_accel(2, raw),
+                .temperature = map_temperature(raw.temperature)};
+    }
 
     /**
      * @brief Maps raw X-axis gyroscope value to angular velocity in degrees per second.
      * @param raw Raw 16-bit value from sensor.
-     * @return Angular velocity in °/s.
+     * @return Angular velocity in °/s, bias removed.
      */
-    float map_gyro_x(int16_t raw) const;
+    constexpr float map_gyro_x(int16_t raw) const noexcept
+    {
+        return raw * m_gyro_scale - m_gyro_bias.gx;
+    }
 
     /**
      * @brief Maps raw Y-axis gyroscope value to angular velocity in degrees per second.
      * @param raw Raw 16-bit value from sensor.
-     * @return Angular velocity in °/s.
+     * @return Angular velocity in °/s, bias removed.
      */
-    float map_gyro_y(int16_t raw) const;
+    constexpr float map_gyro_y(int16_t raw) const noexcept
+    {
+        return raw * m_gyro_scale - m_gyro_bias.gy;
+    }
 
     /**
      * @brief Maps raw Z-axis gyroscope value to angular velocity in degrees per second.
      * @param raw Raw 16-bit value from sensor.
-     * @return Angular velocity in °/s.
+     * @return Angular velocity in °/s, bias removed.
      */
-    float map_gyro_z(int16_t raw) const;
+    constexpr float map_gyro_z(int16_t raw) const noexcept
+    {
+        return raw * m_gyro_scale - m_gyro_bias.gz;
+    }
+
+    /**
+     * @brief Maps raw die temperature value to degrees Celsius.
+     * @param raw Raw 16-bit value from sensor.
+     * @return Temperature in °C.
+     */
+    constexpr float map_temperature(int16_t raw) const noexcept
+    {
+        return raw * TEMP_SCALE + TEMP_OFFSET;
+    }
 
 private:
     /**
-     * @brief Internal helper to convert raw accelerometer value using the specified mode.
-     * @param value Raw value from sensor.
-     * @param mode Sensitivity mode.
-     * @return Acceleration in g.
+     * @brief Maps the raw accelerometer vector to one corrected axis in g.
      */
-    float map_accel(int16_t value, AccelSensitivityMode mode) const;
+    constexpr float map_accel(size_t axis, const MPU6050RawFrame &raw) const noexcept
+    {
+        const float(&row)[3] = m_accel_transform[axis];
+        return row[0] * raw.ax + row[1] * raw.ay + row[2] * raw.az + m_accel_correction.offset[axis];
+    }
 
     /**
-     * @brief Internal helper to convert raw gyroscope value using the specified mode.
-     * @param value Raw value from sensor.
-     * @param mode Sensitivity mode.
-     * @return Angular velocity in °/s.
+     * @brief Folds the sensitivity into the correction matrix.
      */
-    float map_gyro(int16_t value, GyroSensitivityMode mode) const;
-
-    AccelSensitivityMode m_ax_mode;
-    AccelSensitivityMode m_ay_mode;
-    AccelSensitivityMode m_az_mode;
-    GyroSensitivityMode m_gx_mode;
-    GyroSensitivityMode m_gy_mode;
-    GyroSensitivityMode m_gz_mode;
+    constexpr void fuse_accel_transform() noexcept
+    {
+        for (size_t i = 0; i != 3; ++i) {
+            for (size_t j = 0; j != 3; ++j) {
+                m_accel_transform[i][j] = m_accel_correction.matrix[i][j] * m_accel_scale;
+            }
+        }
+    }
+
+    /// Sensitivity per AFS_SEL value, in LSB/g.
+    static constexpr float ACCEL_LSB_PER_G[] = {16384.0f, 8192.0f, 4096.0f, 2048.0f};
+
+    /// Sensitivity per FS_SEL value, in LSB/(°/s).
+    static constexpr float GYRO_LSB_PER_DPS[] = {131.0f, 65.5f, 32.8f, 16.4f};
+
+    static constexpr float TEMP_SCALE = 1.0f / 340.0f;
+    static constexpr float TEMP_OFFSET = 36.53f;
+
+    /// Acceleration of one LSB, in g.
+    float m_accel_scale;
+
+    /// Angular velocity of one LSB, in °/s.
+    float m_gyro_scale;
+
+    /// Gyroscope offset in °/s.
+    GyroBias m_gyro_bias{};
+
+    /// Accelerometer correction in g.
+    AccelCorrection m_accel_correction{};
+
+    /// Correction matrix times the sensitivity, mapping raw values to g.
+    float m_accel_transform[3][3]{};
 };
 
-} // namespace kopter
\ No newline at end of file
+} // namespace kopter
@@ -17,6 +17,8 @@
 #include "pch.hpp"
 #include "Task.hpp"
 
+#include <cassert>
+
 namespace kopter {
 
 namespace {
@@ -25,17 +27,28 @@ constexpr uint8_t TASK_PRIORITY_DEFAULT = 5;
 
 Task::Task(const char *task_name, uint32_t stack_size, TaskFn fn) : m_fn(std::move(fn))
 {
-    xTaskCreate(Task::task_trampoline, task_name, stack_size, this, TASK_PRIORITY_DEFAULT, nullptr);
+    xTaskCreate(Task::task_trampoline, task_name, stack_size, this, TASK_PRIORITY_DEFAULT, &m_handle);
 }
 
-Task::Task(const char *task_name, uint32_t stack_size, UBaseType_t priority, TaskFn fn)
+Task::Task(const char *task_name, uint32_t stack_size, UBaseType_t priority, TaskFn fn) : m_fn(std::move(fn))
 {
+    xTaskCreate(Task::task_trampoline, task_name, stack_size, this, priority, &m_handle);
 }
 
 Task::Task(const char *task_name, uint32_t stack_size, UBaseType_t priority, BaseType_t coreId, TaskFn fn)
     : m_fn(std::move(fn))
 {
-    xTaskCreatePinnedToCore(Task::task_trampoline, task_name, stack_size, this, priority, nullptr, coreId);
+    xTaskCreatePinnedToCore(Task::task_trampoline, task_name, stack_size, this, priority, &m_handle, coreId);
+}
+
+Task::Task(const char *task_name, uint32_t stack_size, const TaskPlacement &placement, TaskFn fn)
+    : Task(task_name, stack_size, placement.priority, placement.core_id, std::move(fn))
+{
+}
+
+TaskHandle_t Task::get_handle() const noexcept
+{
+    return m_handle;
 }
 
 void Task::task_trampoline(void *param)
@@ -31,7 +31,7 @@ constexpr std::string_view TAG = "[CommunicationService]";
 CommunicationService::CommunicationService(std::unique_ptr<IMessageTransport> transport) noexcept
     : m_transport{std::move(transport)}, m_rx_queue{nullptr}
 {
-    m_rx_queue = xQueueCreate(RX_QUEUE_SIZE, sizeof(Message *));
+    m_rx_queue = xQueueCreate(RX_QUEUE_SIZE, sizeof(Message));
     if (m_rx_queue == nullptr) {
         ESP_LOGE(TAG.data(), "Failed to create messages queue.");
         return;
@@ -66,18 +66,18 @@ void CommunicationService::set_rx_callback(RxCallback rx_cb) noexcept
 
 void CommunicationService::create_rx_task()
 {
-    m_rx_task = std::make_unique<Task>(RX_MESSAGE_TASK_NAME.data(), RX_MESSAGE_TASK_STACK_SIZE, [this]() {
-        Message *msg_ptr = nullptr;
+    m_rx_task = std::make_unique<Task>(
+        RX_MESSAGE_TASK_NAME.data(), RX_MESSAGE_TASK_STACK_SIZE, TaskPlan::MESSAGE_RX, [this]() {
+            Message msg{};
 
-        while (true) {
-            if (xQueueReceive(m_rx_queue, &msg_ptr, portMAX_DELAY) == pdTRUE) {
-                if (msg_ptr && m_rx_cb) {
-                    m_rx_cb(*msg_ptr);
-                    delete msg_ptr;
+            while (true) {
+                if (xQueueReceive(m_rx_queue, &msg, portMAX_DELAY) == pdTRUE) {
+                    if (m_rx_cb) {
+                        m_rx_cb(msg);
+                    }
                 }
             }
-        }
-    });
+        });
 }
 
 } // namespace kopter
\ No newline at end of file
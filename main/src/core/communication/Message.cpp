@@ -20,6 +20,7 @@
 #include "ByteUtils.hpp"
 #include "CRCUtils.hpp"
 
+#include <cassert>
 #include <cstring>
 
 namespace kopter {
@@ -69,4 +70,36 @@ void Message::serialize(uint8_t *buffer) const
     ByteUtils::write_u16_le(computed_crc, buffer + OFFSET_CRC);
 }
 
+Message Message::make_qnh(uint16_t qnh_dhpa) noexcept
+{
+    return {.type = MessageType::QNH,
+            .throttle = static_cast<uint8_t>(qnh_dhpa & 0xFF),
+            .roll = static_cast<int8_t>(qnh_dhpa >> 8),
+            .pitch = 0,
+            .yaw = 0,
+            .crc = 0};
+}
+
+uint16_t Message::get_qnh_dhpa() const noexcept
+{
+    assert(type == MessageType::QNH);
+    return ByteUtils::get_u16_le(throttle, static_cast<uint8_t>(roll));
+}
+
+Message Message::make_arm(bool armed) noexcept
+{
+    return {.type = MessageType::ARM,
+            .throttle = static_cast<uint8_t>(armed ? 1 : 0),
+            .roll = 0,
+            .pitch = 0,
+            .yaw = 0,
+            .crc = 0};
+}
+
+bool Message::is_arm_request() const noexcept
+{
+    assert(type == MessageType::ARM);
+    return throttle != 0;
+}
+
 } // namespace kopter
\ No newline at end of file
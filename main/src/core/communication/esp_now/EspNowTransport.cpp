@@ -82,9 +82,8 @@ void IRAM_ATTR EspNowTransport::on_receive_cb(const esp_now_recv_info_t *esp_now
         return;
     }
 
-    auto *msg = new Message(std::move(msg_opt.value()));
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    xQueueSendFromISR(s_instance->m_rx_queue, &msg, &xHigherPriorityTaskWoken);
+    xQueueSendFromISR(s_instance->m_rx_queue, &msg_opt.value(), &xHigherPriorityTaskWoken);
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
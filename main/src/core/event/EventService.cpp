@@ -17,6 +17,8 @@
 #include "pch.hpp"
 #include "EventService.hpp"
 
+#include "TaskPlan.hpp"
+
 using namespace idf::event;
 
 namespace kopter {
@@ -24,9 +26,7 @@ namespace kopter {
 namespace {
 constexpr uint16_t QUEUE_SIZE = 64;
 constexpr std::string_view TASK_NAME = "event_task";
-constexpr uint16_t TASK_PRIORITY = 5;
 constexpr uint32_t TASK_STACK_SIZE = 4096;
-constexpr uint16_t CORE_ID = 0;
 } // namespace
 
 static esp_event_loop_args_t make_loop_args()
@@ -34,9 +34,9 @@ static esp_event_loop_args_t make_loop_args()
     esp_event_loop_args_t args;
     args.queue_size = QUEUE_SIZE;
     args.task_name = TASK_NAME.data();
-    args.task_priority = TASK_PRIORITY;
+    args.task_priority = TaskPlan::EVENT_LOOP.priority;
     args.task_stack_size = TASK_STACK_SIZE;
-    args.task_core_id = CORE_ID;
+    args.task_core_id = TaskPlan::EVENT_LOOP.core_id;
 
     return args;
 }
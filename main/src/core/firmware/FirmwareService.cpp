@@ -29,6 +29,9 @@ namespace {
 constexpr uint16_t DEFAULT_VERSION = 1;
 constexpr std::string_view STORAGE_NAME = "storage";
 constexpr std::string_view VERSION_KEY = "version";
+constexpr std::string_view GYRO_BIAS_KEY = "gyro_bias";
+constexpr std::string_view ACCEL_CORRECTION_KEY = "accel_corr";
+constexpr std::string_view ACCEL_CALIBRATION_REQUEST_KEY = "accel_cal_req";
 constexpr std::string_view TAG = "[FirmwareService]";
 } // namespace
 
@@ -78,6 +81,76 @@ void FirmwareService::set_version(const uint16_t new_version)
     }
 }
 
+std::optional<GyroBias> FirmwareService::get_gyro_bias()
+{
+    return get_blob<GyroBias>(GYRO_BIAS_KEY);
+}
+
+void FirmwareService::set_gyro_bias(const GyroBias &bias)
+{
+    set_blob(GYRO_BIAS_KEY, bias);
+}
+
+std::optional<AccelCorrection> FirmwareService::get_accel_correction()
+{
+    return get_blob<AccelCorrection>(ACCEL_CORRECTION_KEY);
+}
+
+void FirmwareService::set_accel_correction(const AccelCorrection &correction)
+{
+    set_blob(ACCEL_CORRECTION_KEY, correction);
+}
+
+bool FirmwareService::is_accel_calibration_requested()
+{
+    return get_blob<uint8_t>(ACCEL_CALIBRATION_REQUEST_KEY).value_or(0) != 0;
+}
+
+void FirmwareService::set_accel_calibration_requested(bool requested)
+{
+    set_blob(ACCEL_CALIBRATION_REQUEST_KEY, static_cast<uint8_t>(requested));
+}
+
+template <typename T> std::optional<T> FirmwareService::get_blob(std::string_view key)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    auto handler = open_nvs();
+    if (handler == nullptr) {
+        return std::nullopt;
+    }
+
+    // A blob of another size was written by a firmware with a different layout.
+    size_t size = 0;
+    if (handler->get_item_size(ItemType::BLOB, key.data(), size) != ESP_OK || size != sizeof(T)) {
+        return std::nullopt;
+    }
+
+    T value;
+    if (handler->get_blob(key.data(), &value, sizeof(value)) != ESP_OK) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+template <typename T> void FirmwareService::set_blob(std::string_view key, const T &value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    auto handler = open_nvs();
+    if (handler == nullptr) {
+        return;
+    }
+    if (handler->set_blob(key.data(), &value, sizeof(value)) != ESP_OK) {
+        ESP_LOGE(TAG.data(), "Failed to save \"%s\"", key.data());
+        return;
+    }
+    if (handler->commit() != ESP_OK) {
+        ESP_LOGE(TAG.data(), "Failed to commit changes");
+        return;
+    }
+}
+
 std::unique_ptr<nvs::NVSHandle> FirmwareService::open_nvs()
 {
     esp_err_t ret;
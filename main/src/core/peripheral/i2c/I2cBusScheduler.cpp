@@ -0,0 +1,166 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "pch.hpp"
+#include "I2cBusScheduler.hpp"
+
+#include "I2cDevice.hpp"
+#include "I2cException.hpp"
+
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+
+namespace kopter {
+
+namespace {
+constexpr std::string_view TASK_NAME = "i2c_bus";
+constexpr uint32_t TASK_STACK_SIZE = 3072;
+constexpr UBaseType_t QUEUE_LENGTH = 8;
+} // namespace
+
+I2cBusScheduler::I2cBusScheduler()
+{
+    for (auto &queue : m_queues) {
+        queue = xQueueCreate(QUEUE_LENGTH, sizeof(I2cTransaction *));
+        if (queue == nullptr) {
+            throw I2cException(ESP_ERR_NO_MEM);
+        }
+    }
+    m_task = std::make_unique<Task>(TASK_NAME.data(), TASK_STACK_SIZE, TaskPlan::I2C_BUS, [this]() { process(); });
+}
+
+void I2cBusScheduler::submit(I2cTransaction &transaction)
+{
+    if (!enqueue(transaction)) {
+        throw I2cException(ESP_ERR_NO_MEM);
+    }
+}
+
+void I2cBusScheduler::run(I2cTransaction &transaction)
+{
+    if (xTaskGetCurrentTaskHandle() == m_task_handle.load(std::memory_order_acquire)) {
+        transaction.device->execute(transaction);
+        return;
+    }
+
+    StaticSemaphore_t done_storage;
+    SemaphoreHandle_t done = xSemaphoreCreateBinaryStatic(&done_storage);
+    transaction.on_complete = [](I2cTransaction &, void *context) {
+        xSemaphoreGive(static_cast<SemaphoreHandle_t>(context));
+    };
+    transaction.context = done;
+
+    const bool queued = enqueue(transaction);
+    if (queued) {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+    vSemaphoreDelete(done);
+
+    if (!queued) {
+        throw I2cException(ESP_ERR_NO_MEM);
+    }
+}
+
+uint32_t I2cBusScheduler::get_depth(I2cPriority priority) const noexcept
+{
+    return uxQueueMessagesWaiting(m_queues[static_cast<size_t>(priority)]);
+}
+
+I2cQueueStats I2cBusScheduler::get_stats(I2cPriority priority) const noexcept
+{
+    const QueueCounters &counters = m_counters[static_cast<size_t>(priority)];
+    return {.completed = counters.completed.load(std::memory_order_relaxed),
+            .max_depth = counters.max_depth.load(std::memory_order_relaxed),
+            .total_wait_us = counters.total_wait_us.load(std::memory_order_relaxed),
+            .max_wait_us = counters.max_wait_us.load(std::memory_order_relaxed)};
+}
+
+void I2cBusScheduler::reset_stats() noexcept
+{
+    m_reset_requested.store(true, std::memory_order_relaxed);
+}
+
+void I2cBusScheduler::process()
+{
+    m_task_handle.store(xTaskGetCurrentTaskHandle(), std::memory_order_release);
+
+    while (true) {
+        // Drain before sleeping: transactions may have been queued before the task handle was published.
+        size_t level = 0;
+        while (I2cTransaction *transaction = pop(level)) {
+            execute(*transaction, m_counters[level], uxQueueMessagesWaiting(m_queues[level]) + 1);
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+bool I2cBusScheduler::enqueue(I2cTransaction &transaction)
+{
+    const auto level = static_cast<size_t>(transaction.device->get_priority());
+    I2cTransaction *item = &transaction;
+
+    transaction.submitted_us = esp_timer_get_time();
+    if (xQueueSend(m_queues[level], &item, 0) != pdTRUE) {
+        return false;
+    }
+    if (TaskHandle_t handle = m_task_handle.load(std::memory_order_acquire)) {
+        xTaskNotifyGive(handle);
+    }
+    return true;
+}
+
+I2cTransaction *I2cBusScheduler::pop(size_t &level)
+{
+    I2cTransaction *transaction = nullptr;
+    for (level = 0; level != I2C_PRIORITY_COUNT; ++level) {
+        if (xQueueReceive(m_queues[level], &transaction, 0) == pdTRUE) {
+            return transaction;
+        }
+    }
+    return nullptr;
+}
+
+void I2cBusScheduler::execute(I2cTransaction &transaction, QueueCounters &counters, uint32_t depth)
+{
+    if (m_reset_requested.exchange(false, std::memory_order_relaxed)) {
+        for (auto &level_counters : m_counters) {
+            level_counters.completed.store(0, std::memory_order_relaxed);
+            level_counters.max_depth.store(0, std::memory_order_relaxed);
+            level_counters.total_wait_us.store(0, std::memory_order_relaxed);
+            level_counters.max_wait_us.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    const auto wait_us = static_cast<uint32_t>(esp_timer_get_time() - transaction.submitted_us);
+    counters.completed.fetch_add(1, std::memory_order_relaxed);
+    counters.total_wait_us.fetch_add(wait_us, std::memory_order_relaxed);
+    if (wait_us > counters.max_wait_us.load(std::memory_order_relaxed)) {
+        counters.max_wait_us.store(wait_us, std::memory_order_relaxed);
+    }
+    if (depth > counters.max_depth.load(std::memory_order_relaxed)) {
+        counters.max_depth.store(depth, std::memory_order_relaxed);
+    }
+
+    transaction.device->execute(transaction);
+
+    // The transaction may be gone as soon as the callback returns, e.g. when a blocked `run` caller resumes.
+    if (transaction.on_complete) {
+        transaction.on_complete(transaction, transaction.context);
+    }
+}
+
+} // namespace kopter
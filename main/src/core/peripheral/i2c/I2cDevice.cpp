@@ -17,12 +17,29 @@
 #include "pch.hpp"
 #include "I2cDevice.hpp"
 
-using namespace idf;
+#include "esp_timer.h"
+
+#if CONFIG_I2C_BUS_SCHEDULER
+#include "I2cBusScheduler.hpp"
+#endif
 
 namespace kopter {
 
-I2cDevice::I2cDevice(const idf::I2CAddress &address, I2CMaster *shared_master)
-    : IDevice(), m_address{address}, m_master{shared_master}
+namespace {
+constexpr TickType_t TIMEOUT_TICKS = pdMS_TO_TICKS(10);
+} // namespace
+
+I2cDevice::I2cDevice(uint8_t address, i2c_port_t port, I2cPriority priority, I2cBusScheduler *scheduler)
+    : IDevice(),
+      m_address{address},
+      m_port{port},
+      m_priority{priority},
+      m_scheduler{scheduler},
+      m_transactions{0},
+      m_errors{0},
+      m_total_us{0},
+      m_max_us{0},
+      m_reset_requested{false}
 {
 }
 
@@ -31,20 +48,104 @@ const char *I2cDevice::get_name() const noexcept
     return "[I2cDevice]";
 }
 
-void I2cDevice::write(const std::vector<uint8_t> &data)
+void I2cDevice::write(std::span<const uint8_t> data)
 {
-    m_master->sync_write(m_address, data);
+    I2cTransaction transaction{.device = this, .write_data = data};
+    run(transaction);
 }
 
-std::vector<uint8_t> I2cDevice::read(const uint8_t reg, const uint16_t n_bytes)
+void I2cDevice::write(const uint8_t reg, std::span<const uint8_t> data)
 {
-    m_master->sync_write(m_address, {reg});
-    return m_master->sync_read(m_address, n_bytes);
+    if (data.size() > MAX_WRITE_BYTES) {
+        throw I2cException(ESP_ERR_INVALID_SIZE);
+    }
+
+    std::array<uint8_t, MAX_WRITE_BYTES + 1> frame;
+    frame[0] = reg;
+    std::copy(data.begin(), data.end(), frame.begin() + 1);
+    write(std::span<const uint8_t>(frame.data(), data.size() + 1));
 }
 
-const idf::I2CAddress &I2cDevice::get_address() const noexcept
+void I2cDevice::write(const uint8_t reg, const uint8_t value)
+{
+    const std::array<uint8_t, 2> frame{reg, value};
+    write(frame);
+}
+
+void I2cDevice::read(const uint8_t reg, std::span<uint8_t> data)
+{
+    I2cTransaction transaction{.device = this, .write_data = {&reg, 1}, .read_data = data};
+    run(transaction);
+}
+
+uint8_t I2cDevice::get_address() const noexcept
 {
     return m_address;
 }
 
-} // namespace kopter
\ No newline at end of file
+I2cPriority I2cDevice::get_priority() const noexcept
+{
+    return m_priority;
+}
+
+void I2cDevice::execute(I2cTransaction &transaction) noexcept
+{
+    const auto &write_data = transaction.write_data;
+    const auto &read_data = transaction.read_data;
+    const int64_t start_us = esp_timer_get_time();
+    transaction.result =
+        read_data.empty()
+            ? i2c_master_write_to_device(m_port, m_address, write_data.data(), write_data.size(), TIMEOUT_TICKS)
+            : i2c_master_write_read_device(m_port,
+                                           m_address,
+                                           write_data.data(),
+                                           write_data.size(),
+                                           read_data.data(),
+                                           read_data.size(),
+                                           TIMEOUT_TICKS);
+    const auto elapsed_us = static_cast<uint32_t>(esp_timer_get_time() - start_us);
+
+    if (m_reset_requested.exchange(false, std::memory_order_relaxed)) {
+        m_transactions.store(0, std::memory_order_relaxed);
+        m_errors.store(0, std::memory_order_relaxed);
+        m_total_us.store(0, std::memory_order_relaxed);
+        m_max_us.store(0, std::memory_order_relaxed);
+    }
+
+    m_transactions.fetch_add(1, std::memory_order_relaxed);
+    m_total_us.fetch_add(elapsed_us, std::memory_order_relaxed);
+    if (elapsed_us > m_max_us.load(std::memory_order_relaxed)) {
+        m_max_us.store(elapsed_us, std::memory_order_relaxed);
+    }
+    if (transaction.result != ESP_OK) {
+        m_errors.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+I2cStats I2cDevice::get_stats() const noexcept
+{
+    return {.transactions = m_transactions.load(std::memory_order_relaxed),
+            .errors = m_errors.load(std::memory_order_relaxed),
+            .total_us = m_total_us.load(std::memory_order_relaxed),
+            .max_us = m_max_us.load(std::memory_order_relaxed)};
+}
+
+void I2cDevice::reset_stats() noexcept
+{
+    m_reset_requested.store(true, std::memory_order_relaxed);
+}
+
+void I2cDevice::run(I2cTransaction &transaction)
+{
+#if CONFIG_I2C_BUS_SCHEDULER
+    if (m_scheduler) {
+        m_scheduler->run(transaction);
+        check_call<I2cException>(transaction.result);
+        return;
+    }
+#endif
+    execute(transaction);
+    check_call<I2cException>(transaction.result);
+}
+
+} // namespace kopter
@@ -18,20 +18,38 @@
 #include "I2cDeviceHolder.hpp"
 #include "I2cException.hpp"
 
-using namespace idf;
-
 namespace kopter {
 
 namespace {
-constexpr uint32_t SDA_PIN = CONFIG_I2C_SDA_PIN;
-constexpr uint32_t SCL_PIN = CONFIG_I2C_SCL_PIN;
+constexpr gpio_num_t SDA_PIN = static_cast<gpio_num_t>(CONFIG_I2C_SDA_PIN);
+constexpr gpio_num_t SCL_PIN = static_cast<gpio_num_t>(CONFIG_I2C_SCL_PIN);
 constexpr uint32_t FREQUENCY = 400000;
+constexpr i2c_port_t PORT = I2C_NUM_0;
+constexpr std::string_view TAG = "[I2cDeviceHolder]";
 } // namespace
 
 I2cDeviceHolder::I2cDeviceHolder()
-    : m_master{
-          std::make_unique<I2CMaster>(I2CNumber::I2C0(), SCL_GPIO(SCL_PIN), SDA_GPIO(SDA_PIN), Frequency(FREQUENCY))}
 {
+    // The legacy driver is used directly: its blocking master calls build their command links on the stack,
+    // while the esp-idf-cxx I2CMaster allocates a transfer object and a result vector on every call.
+    i2c_config_t config{};
+    config.mode = I2C_MODE_MASTER;
+    config.sda_io_num = SDA_PIN;
+    config.scl_io_num = SCL_PIN;
+    config.sda_pullup_en = GPIO_PULLUP_ENABLE;
+    config.scl_pullup_en = GPIO_PULLUP_ENABLE;
+    config.master.clk_speed = FREQUENCY;
+    check_call<I2cException>(i2c_param_config(PORT, &config));
+    check_call<I2cException>(i2c_driver_install(PORT, config.mode, 0, 0, 0));
+#if CONFIG_I2C_BUS_SCHEDULER
+    m_scheduler = new I2cBusScheduler();
+#endif
+}
+
+I2cDeviceHolder::~I2cDeviceHolder()
+{
+    m_devices.clear();
+    i2c_driver_delete(PORT);
 }
 
 I2cDeviceHolder &I2cDeviceHolder::get_instance()
@@ -40,16 +58,50 @@ I2cDeviceHolder &I2cDeviceHolder::get_instance()
     return instance;
 }
 
-I2cDevice *I2cDeviceHolder::add_device(const std::string &name, const uint8_t &address)
+I2cDevice *I2cDeviceHolder::add_device(const std::string &name, const uint8_t &address, I2cPriority priority)
 {
-    assert(m_master);
-
     if (m_devices.find(name) != m_devices.end()) {
         return m_devices[name].get();
     }
 
-    m_devices[name] = std::make_unique<I2cDevice>(I2CAddress(std::move(address)), m_master.get());
+#if CONFIG_I2C_BUS_SCHEDULER
+    m_devices[name] = std::make_unique<I2cDevice>(address, PORT, priority, m_scheduler);
+#else
+    m_devices[name] = std::make_unique<I2cDevice>(address, PORT, priority, nullptr);
+#endif
     return m_devices[name].get();
 }
 
+void I2cDeviceHolder::log_stats()
+{
+    for (const auto &[name, device] : m_devices) {
+        const I2cStats stats = device->get_stats();
+        ESP_LOGI(TAG.data(),
+                 "%s: %lu transactions, %lu errors, avg %lu us, max %lu us",
+                 name.c_str(),
+                 static_cast<unsigned long>(stats.transactions),
+                 static_cast<unsigned long>(stats.errors),
+                 static_cast<unsigned long>(stats.transactions ? stats.total_us / stats.transactions : 0),
+                 static_cast<unsigned long>(stats.max_us));
+        device->reset_stats();
+    }
+
+#if CONFIG_I2C_BUS_SCHEDULER
+    constexpr std::array<std::string_view, I2C_PRIORITY_COUNT> PRIORITY_NAMES{"IMU", "barometer", "housekeeping"};
+    for (size_t level = 0; level != I2C_PRIORITY_COUNT; ++level) {
+        const auto priority = static_cast<I2cPriority>(level);
+        const I2cQueueStats stats = m_scheduler->get_stats(priority);
+        ESP_LOGI(TAG.data(),
+                 "%s queue: %lu completed, depth %lu (max %lu), wait avg %lu us, max %lu us",
+                 PRIORITY_NAMES[level].data(),
+                 static_cast<unsigned long>(stats.completed),
+                 static_cast<unsigned long>(m_scheduler->get_depth(priority)),
+                 static_cast<unsigned long>(stats.max_depth),
+                 static_cast<unsigned long>(stats.completed ? stats.total_wait_us / stats.completed : 0),
+                 static_cast<unsigned long>(stats.max_wait_us));
+    }
+    m_scheduler->reset_stats();
+#endif
+}
+
 } // namespace kopter
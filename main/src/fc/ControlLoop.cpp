@@ -0,0 +1,231 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "pch.hpp"
+#include "ControlLoop.hpp"
+
+#include "HeapGuard.hpp"
+
+#include <cstdlib>
+
+namespace kopter {
+
+namespace {
+constexpr uint32_t MICROS_PER_SECOND = 1000000;
+constexpr std::string_view TASK_NAME = "control_loop";
+constexpr uint32_t TASK_STACK_SIZE = 4096;
+constexpr std::string_view TIMER_NAME = "control_loop";
+constexpr std::string_view TAG = "[ControlLoop]";
+// A failing sensor throws on every tick, so its errors are logged at most once per interval.
+constexpr int64_t ERROR_LOG_INTERVAL_US = 1000000;
+} // namespace
+
+ControlLoop::ControlLoop(StepFn step_fn, void *context, uint32_t rate_hz)
+    : m_step_fn{step_fn},
+      m_context{context},
+      m_period_us{MICROS_PER_SECOND / rate_hz},
+      m_timer{nullptr},
+      m_exited{xSemaphoreCreateBinaryStatic(&m_exited_storage)},
+      m_last_start_us{0},
+      m_last_error_log_us{0},
+      m_unlogged_errors{0},
+      m_stats_lock{portMUX_INITIALIZER_UNLOCKED}
+{
+    reset_stats();
+
+    esp_timer_create_args_t timer_args{};
+    timer_args.callback = &ControlLoop::on_timer_cb;
+    timer_args.arg = this;
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+    timer_args.dispatch_method = ESP_TIMER_ISR;
+#else
+    timer_args.dispatch_method = ESP_TIMER_TASK;
+#endif
+    timer_args.name = TIMER_NAME.data();
+    timer_args.skip_unhandled_events = true;
+
+    check_call<KopterException>(esp_timer_create(&timer_args, &m_timer));
+}
+
+ControlLoop::~ControlLoop()
+{
+    stop();
+    if (m_timer) {
+        esp_timer_delete(m_timer);
+    }
+    vSemaphoreDelete(m_exited);
+}
+
+void ControlLoop::start(ControlLoopTrigger trigger)
+{
+    if (m_running.exchange(true)) {
+        return;
+    }
+
+    m_last_start_us = 0;
+    m_task = std::make_unique<Task>(TASK_NAME.data(), TASK_STACK_SIZE, TaskPlan::CONTROL_LOOP, [this]() { run(); });
+    if (m_task->get_handle() == nullptr) {
+        m_task.reset();
+        m_running.store(false);
+        throw KopterException(ESP_ERR_NO_MEM);
+    }
+    m_task_handle.store(m_task->get_handle(), std::memory_order_release);
+    if (trigger == ControlLoopTrigger::TIMER) {
+        check_call<KopterException>(esp_timer_start_periodic(m_timer, m_period_us));
+    }
+
+    ESP_LOGI(TAG.data(),
+             "Started at %lu us period on core %d, %s-triggered",
+             m_period_us,
+             TaskPlan::CONTROL_LOOP.core_id,
+             trigger == ControlLoopTrigger::TIMER ? "timer" : "externally");
+}
+
+void ControlLoop::stop()
+{
+    if (!m_running.exchange(false)) {
+        return;
+    }
+
+    esp_timer_stop(m_timer);
+
+    // Unpublish the handle so the triggers stop notifying a task that is about to be deleted, then wake the task
+    // so it observes the stop request and join it.
+    TaskHandle_t handle = m_task_handle.exchange(nullptr, std::memory_order_acq_rel);
+    xTaskNotifyGive(handle);
+    xSemaphoreTake(m_exited, portMAX_DELAY);
+    m_task.reset();
+}
+
+ControlLoopStats ControlLoop::get_stats() const
+{
+    taskENTER_CRITICAL(&m_stats_lock);
+    ControlLoopStats stats = m_stats;
+    taskEXIT_CRITICAL(&m_stats_lock);
+
+    return stats;
+}
+
+void ControlLoop::reset_stats()
+{
+    taskENTER_CRITICAL(&m_stats_lock);
+    m_stats = ControlLoopStats{};
+    m_stats.min_period_us = INT64_MAX;
+    taskEXIT_CRITICAL(&m_stats_lock);
+}
+
+void IRAM_ATTR ControlLoop::on_timer_cb(void *arg)
+{
+    auto *self = static_cast<ControlLoop *>(arg);
+    TaskHandle_t handle = self->m_task_handle.load(std::memory_order_acquire);
+    if (handle == nullptr) {
+        return;
+    }
+
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(handle, &higher_priority_task_woken);
+    if (higher_priority_task_woken == pdTRUE) {
+        esp_timer_isr_dispatch_need_yield();
+    }
+#else
+    xTaskNotifyGive(handle);
+#endif
+}
+
+void IRAM_ATTR ControlLoop::trigger_from_isr(void *arg)
+{
+    auto *self = static_cast<ControlLoop *>(arg);
+    TaskHandle_t handle = self->m_task_handle.load(std::memory_order_acquire);
+    if (handle == nullptr) {
+        return;
+    }
+
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(handle, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+void ControlLoop::run()
+{
+    HeapGuard::arm(xTaskGetCurrentTaskHandle());
+
+    while (m_running.load(std::memory_order_acquire)) {
+        // Every notification is one tick of the trigger; more than one means the previous iteration overran.
+        const uint32_t pending = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!m_running.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        const int64_t start_us = esp_timer_get_time();
+        try {
+            m_step_fn(m_context, start_us);
+        }
+        catch (const KopterException &e) {
+            taskENTER_CRITICAL(&m_stats_lock);
+            ++m_stats.errors;
+            taskEXIT_CRITICAL(&m_stats_lock);
+            log_error(e, start_us);
+        }
+        record(start_us, esp_timer_get_time(), pending);
+    }
+
+    HeapGuard::disarm();
+    xSemaphoreGive(m_exited);
+}
+
+void ControlLoop::log_error(const KopterException &e, int64_t now_us)
+{
+    ++m_unlogged_errors;
+    if (m_last_error_log_us != 0 && now_us - m_last_error_log_us < ERROR_LOG_INTERVAL_US) {
+        return;
+    }
+
+    // Logging may allocate; keep it out of the heap guard's count.
+    HeapGuard::disarm();
+    ESP_LOGE(TAG.data(),
+             "Iteration failed: %s (%lu errors since the last report)",
+             e.what(),
+             static_cast<unsigned long>(m_unlogged_errors));
+    HeapGuard::arm(xTaskGetCurrentTaskHandle());
+    m_last_error_log_us = now_us;
+    m_unlogged_errors = 0;
+}
+
+void ControlLoop::record(int64_t start_us, int64_t end_us, uint32_t pending)
+{
+    const int64_t exec_us = end_us - start_us;
+    const int64_t period_us = m_last_start_us ? start_us - m_last_start_us : m_period_us;
+    const int64_t jitter_us = std::llabs(period_us - static_cast<int64_t>(m_period_us));
+    const uint32_t missed = pending > 1 ? pending - 1 : 0;
+    m_last_start_us = start_us;
+
+    taskENTER_CRITICAL(&m_stats_lock);
+    ++m_stats.iterations;
+    m_stats.missed_ticks += missed;
+    if (missed > 0 || exec_us > m_period_us) {
+        ++m_stats.overruns;
+    }
+    m_stats.last_period_us = period_us;
+    m_stats.min_period_us = std::min(m_stats.min_period_us, period_us);
+    m_stats.max_period_us = std::max(m_stats.max_period_us, period_us);
+    m_stats.max_jitter_us = std::max(m_stats.max_jitter_us, jitter_us);
+    m_stats.last_exec_us = exec_us;
+    m_stats.max_exec_us = std::max(m_stats.max_exec_us, exec_us);
+    taskEXIT_CRITICAL(&m_stats_lock);
+}
+
+} // namespace kopter
@@ -0,0 +1,66 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "pch.hpp"
+#include "HeapGuard.hpp"
+
+#include "esp_system.h"
+
+#include <atomic>
+
+namespace kopter {
+
+namespace {
+std::atomic<TaskHandle_t> s_guarded_task{nullptr};
+std::atomic<uint32_t> s_violations{0};
+} // namespace
+
+void HeapGuard::arm(TaskHandle_t task) noexcept
+{
+    s_guarded_task.store(task, std::memory_order_release);
+}
+
+void HeapGuard::disarm() noexcept
+{
+    s_guarded_task.store(nullptr, std::memory_order_release);
+}
+
+uint32_t HeapGuard::get_violations() noexcept
+{
+    return s_violations.load(std::memory_order_relaxed);
+}
+
+void IRAM_ATTR HeapGuard::on_allocation() noexcept
+{
+    TaskHandle_t task = s_guarded_task.load(std::memory_order_acquire);
+    if (task == nullptr || task != xTaskGetCurrentTaskHandle()) {
+        return;
+    }
+
+    s_violations.fetch_add(1, std::memory_order_relaxed);
+#if CONFIG_FC_HEAP_GUARD_ABORT
+    esp_system_abort("Heap allocation in the guarded task");
+#endif
+}
+
+} // namespace kopter
+
+#if CONFIG_FC_HEAP_GUARD
+extern "C" void IRAM_ATTR esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps)
+{
+    kopter::HeapGuard::on_allocation();
+}
+#endif
@@ -0,0 +1,123 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "pch.hpp"
+#include "LoopProfiler.hpp"
+
+#include "esp_cpu.h"
+
+#include <bit>
+
+namespace kopter {
+
+namespace {
+constexpr uint32_t HISTOGRAM_SHIFT = 7;
+constexpr uint64_t CYCLES_PER_US = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+constexpr uint64_t NS_PER_US = 1000;
+constexpr size_t HISTOGRAM_TEXT_SIZE = 128;
+constexpr const char *STAGE_NAMES[] = {
+    "imu", "filter", "predict", "euler", "pid", "baro", "correct", "alt pid", "rate", "mix", "motors"};
+static_assert(std::size(STAGE_NAMES) == static_cast<size_t>(LoopStage::COUNT));
+constexpr std::string_view TAG = "[LoopProfiler]";
+
+constexpr unsigned long long to_ns(uint32_t cycles)
+{
+    return cycles * NS_PER_US / CYCLES_PER_US;
+}
+} // namespace
+
+LoopProfiler::LoopProfiler() noexcept : m_last_cycles{0}, m_reset_requested{true}
+{
+}
+
+void LoopProfiler::start() noexcept
+{
+    if (m_reset_requested.exchange(false, std::memory_order_acquire)) {
+        for (auto &stats : m_stats) {
+            stats = StageStats{};
+            stats.min_cycles = UINT32_MAX;
+        }
+    }
+    m_last_cycles = now();
+}
+
+void LoopProfiler::lap(LoopStage stage) noexcept
+{
+    const uint32_t cycles = now();
+    const uint32_t elapsed = cycles - m_last_cycles;
+    m_last_cycles = cycles;
+
+    auto &stats = m_stats[static_cast<size_t>(stage)];
+    ++stats.count;
+    stats.total_cycles += elapsed;
+    stats.min_cycles = std::min(stats.min_cycles, elapsed);
+    stats.max_cycles = std::max(stats.max_cycles, elapsed);
+
+    const size_t bucket =
+        std::min<size_t>(std::bit_width(elapsed >> HISTOGRAM_SHIFT), StageStats::HISTOGRAM_BUCKETS - 1);
+    ++stats.histogram[bucket];
+}
+
+StageStats LoopProfiler::get_stats(LoopStage stage) const noexcept
+{
+    return m_stats[static_cast<size_t>(stage)];
+}
+
+void LoopProfiler::reset() noexcept
+{
+    m_reset_requested.store(true, std::memory_order_release);
+}
+
+void LoopProfiler::log_stats() const
+{
+    for (size_t i = 0; i != m_stats.size(); ++i) {
+        const auto stage = static_cast<LoopStage>(i);
+        const auto stats = get_stats(stage);
+        if (stats.count == 0) {
+            continue;
+        }
+
+        std::array<char, HISTOGRAM_TEXT_SIZE> histogram{};
+        size_t offset = 0;
+        for (const auto bucket : stats.histogram) {
+            offset += snprintf(
+                histogram.data() + offset, histogram.size() - offset, " %lu", static_cast<unsigned long>(bucket));
+            offset = std::min(offset, histogram.size() - 1);
+        }
+
+        // Most stages of a 1 kHz loop take well under a microsecond, so the durations are printed in ns.
+        ESP_LOGI(TAG.data(),
+                 "%-7s min %7llu avg %7llu max %7llu ns |%s",
+                 get_stage_name(stage),
+                 to_ns(stats.min_cycles),
+                 to_ns(stats.get_avg_cycles()),
+                 to_ns(stats.max_cycles),
+                 histogram.data());
+    }
+}
+
+const char *LoopProfiler::get_stage_name(LoopStage stage) noexcept
+{
+    const auto index = static_cast<size_t>(stage);
+    return index < static_cast<size_t>(LoopStage::COUNT) ? STAGE_NAMES[index] : "unknown";
+}
+
+uint32_t LoopProfiler::now() noexcept
+{
+    return esp_cpu_get_cycle_count();
+}
+
+} // namespace kopter
@@ -0,0 +1,80 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "pch.hpp"
+#include "SetpointChannel.hpp"
+
+namespace kopter {
+
+SetpointChannel::SetpointChannel() noexcept
+    : m_next_sequence{1},
+      m_last_sequence{0},
+      m_received{0},
+      m_overwritten{0},
+      m_last_latency_us{0},
+      m_max_latency_us{0},
+      m_reset_requested{false}
+{
+}
+
+void SetpointChannel::publish(const Setpoint &setpoint) noexcept
+{
+    Setpoint &slot = m_buffer.write_buffer();
+    slot = setpoint;
+    slot.sequence = m_next_sequence++;
+    m_buffer.publish();
+}
+
+const Setpoint *SetpointChannel::consume(int64_t now_us) noexcept
+{
+    if (m_reset_requested.exchange(false, std::memory_order_relaxed)) {
+        m_received.store(0, std::memory_order_relaxed);
+        m_overwritten.store(0, std::memory_order_relaxed);
+        m_last_latency_us.store(0, std::memory_order_relaxed);
+        m_max_latency_us.store(0, std::memory_order_relaxed);
+    }
+
+    if (!m_buffer.update()) {
+        return nullptr;
+    }
+
+    const Setpoint &setpoint = m_buffer.read_buffer();
+    const int32_t latency_us = static_cast<int32_t>(now_us - setpoint.timestamp_us);
+    m_received.fetch_add(1, std::memory_order_relaxed);
+    m_overwritten.fetch_add(setpoint.sequence - m_last_sequence - 1, std::memory_order_relaxed);
+    m_last_latency_us.store(latency_us, std::memory_order_relaxed);
+    if (latency_us > m_max_latency_us.load(std::memory_order_relaxed)) {
+        m_max_latency_us.store(latency_us, std::memory_order_relaxed);
+    }
+    m_last_sequence = setpoint.sequence;
+
+    return &setpoint;
+}
+
+SetpointStats SetpointChannel::get_stats() const noexcept
+{
+    return {.received = m_received.load(std::memory_order_relaxed),
+            .overwritten = m_overwritten.load(std::memory_order_relaxed),
+            .last_latency_us = m_last_latency_us.load(std::memory_order_relaxed),
+            .max_latency_us = m_max_latency_us.load(std::memory_order_relaxed)};
+}
+
+void SetpointChannel::reset_stats() noexcept
+{
+    m_reset_requested.store(true, std::memory_order_relaxed);
+}
+
+} // namespace kopter
@@ -0,0 +1,83 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "pch.hpp"
+#include "VerticalEstimator.hpp"
+
+namespace kopter {
+
+namespace {
+constexpr float GRAVITY = 9.80665f;
+constexpr float MICROS_PER_SECOND = 1e6f;
+} // namespace
+
+VerticalEstimator::VerticalEstimator(float time_constant_s) noexcept
+    : m_altitude_gain{3.0f / time_constant_s},
+      m_velocity_gain{3.0f / (time_constant_s * time_constant_s)},
+      m_bias_gain{1.0f / (time_constant_s * time_constant_s * time_constant_s)},
+      m_altitude{0.0f},
+      m_velocity{0.0f},
+      m_accel_bias{0.0f},
+      m_baro_altitude{0.0f},
+      m_last_timestamp_us{0},
+      m_initialized{false}
+{
+}
+
+void VerticalEstimator::predict(const IMUData &data, const glm::quat &orientation, int64_t timestamp_us) noexcept
+{
+    const int64_t dt_us = timestamp_us - m_last_timestamp_us;
+    m_last_timestamp_us = timestamp_us;
+    if (!m_initialized || dt_us <= 0 || dt_us > MAX_DT_US) {
+        return;
+    }
+    const float dt = dt_us / MICROS_PER_SECOND;
+
+    // The accelerometer measures specific force; at rest it reads +1 g up in the world frame.
+    const float accel_up = ((orientation * glm::vec3(data.ax, data.ay, data.az)).z - 1.0f) * GRAVITY - m_accel_bias;
+    const float error = m_baro_altitude - m_altitude;
+
+    m_accel_bias -= m_bias_gain * error * dt;
+    m_altitude += (m_velocity + 0.5f * accel_up * dt + m_altitude_gain * error) * dt;
+    m_velocity += (accel_up + m_velocity_gain * error) * dt;
+}
+
+void VerticalEstimator::correct(float altitude) noexcept
+{
+    m_baro_altitude = altitude;
+    if (!m_initialized) {
+        m_altitude = altitude;
+        m_initialized = true;
+    }
+}
+
+float VerticalEstimator::get_altitude() const noexcept
+{
+    return m_altitude;
+}
+
+float VerticalEstimator::get_velocity() const noexcept
+{
+    return m_velocity;
+}
+
+float VerticalEstimator::get_accel_bias() const noexcept
+{
+    return m_accel_bias;
+}
+
+} // namespace kopter
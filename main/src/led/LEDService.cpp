@@ -105,7 +105,7 @@ void LEDService::blink(LEDColor color, uint32_t duration)
     stop_blink();
 
     m_blink_running = true;
-    m_blink_task.emplace(BLINK_TASK_NAME.data(), BLINK_TASK_STACK_SIZE, [this, color, duration]() {
+    m_blink_task.emplace(BLINK_TASK_NAME.data(), BLINK_TASK_STACK_SIZE, TaskPlan::LED, [this, color, duration]() {
         while (m_blink_running.load(std::memory_order_acquire)) {
             blink_once(color, duration);
         }
@@ -1,3 +1,300 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "pch.hpp"
+
+#include "AccelCalibration.hpp"
+#include "BMP280.hpp"
+#include "CommunicationService.hpp"
+#include "ComplementaryFilter.hpp"
+#include "ControlLoop.hpp"
+#include "EspNowTransport.hpp"
+#include "EventService.hpp"
+#include "FirmwareService.hpp"
+#include "FlightController.hpp"
+#include "GyroCalibration.hpp"
+#include "HeapGuard.hpp"
+#include "I2cDeviceHolder.hpp"
+#include "MotorFactory.hpp"
+#include "MPU6050.hpp"
+#include "WiFiManager.hpp"
+#include "XMotorMixer.hpp"
+
+using namespace kopter;
+
+namespace {
+constexpr uint8_t MPU6050_ADDRESS = 0x68;
+constexpr uint8_t BMP280_ADDRESS = 0x76;
+constexpr uint32_t STATS_PERIOD_MS = 1000;
+constexpr std::string_view FLIGHT_INIT_TASK_NAME = "flight_init";
+constexpr uint32_t FLIGHT_INIT_TASK_STACK_SIZE = 4096;
+constexpr std::string_view TAG = "[main]";
+
+#if CONFIG_FC_STATIC_PIPELINE
+using Controller = FlightPipeline<MPU6050, BMP280, ComplementaryFilter, XMotorMixer, BDCMotor>;
+#else
+using Controller = FlightController;
+#endif
+
+#if CONFIG_RC_LINK_ENABLED
+constexpr std::array<uint8_t, ESP_NOW_ETH_ALEN> RC_PEER_MAC = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+constexpr float STICK_MAX = 127.0f;
+constexpr uint16_t MIN_QNH_DHPA = 8700;  // 870 hPa, the lowest sea-level pressure on record
+constexpr uint16_t MAX_QNH_DHPA = 10850; // 1085 hPa, the highest
+constexpr float PA_PER_DHPA = 10.0f;
+
+/// Armed state set by ARM messages. Only touched by the rx task, which stamps it into every setpoint; the flight
+/// loop holds the motors at 0 while it is cleared.
+bool s_armed = false;
+
+/**
+ * @brief Converts a received WRITE message into a setpoint stamped with the receive time and the armed state.
+ */
+Setpoint to_setpoint(const Message &msg, int64_t timestamp_us, bool armed)
+{
+    return {.throttle = msg.throttle / static_cast<float>(UINT8_MAX),
+            .roll = msg.roll * (CONFIG_RC_MAX_TILT_DEG / STICK_MAX),
+            .pitch = msg.pitch * (CONFIG_RC_MAX_TILT_DEG / STICK_MAX),
+            .yaw = msg.yaw * (CONFIG_RC_MAX_YAW_DEG / STICK_MAX),
+            .armed = armed,
+            .timestamp_us = timestamp_us};
+}
+
+/**
+ * @brief Returns the QNH of a received QNH message in Pa, or nothing if it is implausible.
+ */
+std::optional<float> to_qnh(const Message &msg)
+{
+    const uint16_t qnh_dhpa = msg.get_qnh_dhpa();
+    if (qnh_dhpa < MIN_QNH_DHPA || qnh_dhpa > MAX_QNH_DHPA) {
+        return std::nullopt;
+    }
+    return qnh_dhpa * PA_PER_DHPA;
+}
+#endif
+
+constexpr MPU6050Config MPU6050_CONFIG{.accel_range = static_cast<AccelSensitivityMode>(CONFIG_MPU6050_AFS_SEL),
+                                       .gyro_range = static_cast<GyroSensitivityMode>(CONFIG_MPU6050_FS_SEL),
+                                       .dlpf = static_cast<DlpfBandwidth>(CONFIG_MPU6050_DLPF_CFG),
+                                       .sample_rate_divider = CONFIG_MPU6050_SAMPLE_RATE_DIVIDER};
+
+#if CONFIG_BMP280_FORCED_MODE
+constexpr BMP280Mode BMP280_MODE = BMP280Mode::FORCED;
+#else
+constexpr BMP280Mode BMP280_MODE = BMP280Mode::NORMAL;
+#endif
+constexpr BMP280Config BMP280_CONFIG =
+    BMP280Config::from_profile(static_cast<BMP280Profile>(CONFIG_BMP280_PROFILE_ID), BMP280_MODE);
+
+#if CONFIG_MPU6050_DATA_READY_INT
+
+/// The loop woken by the data-ready interrupt; null until it exists, so early edges are dropped.
+std::atomic<ControlLoop *> s_control_loop{nullptr};
+
+/**
+ * @brief Data-ready callback of the MPU6050, runs in its GPIO ISR.
+ */
+void IRAM_ATTR wake_control_loop(void *)
+{
+    ControlLoop *control_loop = s_control_loop.load(std::memory_order_acquire);
+    if (control_loop != nullptr) {
+        ControlLoop::trigger_from_isr(control_loop);
+    }
+}
+#endif
+
+/**
+ * @brief Applies the accelerometer correction stored in NVS, running the guided calibration first if it was
+ * requested, see `MessageType::CALIBRATE_ACCEL`.
+ */
+void correct_accel(IMU &imu)
+{
+    auto &firmware = FirmwareService::get_instance();
+#if CONFIG_ACCEL_CALIBRATION
+    if (firmware.is_accel_calibration_requested()) {
+        // Cleared first, so a calibration that is abandoned by powering off does not run again at every boot.
+        firmware.set_accel_calibration_requested(false);
+        AccelCalibration calibration({.sample_period_us = MPU6050_CONFIG.get_sample_period_us()});
+        if (const std::optional<AccelCorrection> correction = calibration.run(imu)) {
+            firmware.set_accel_correction(*correction);
+            return;
+        }
+    }
+#endif
+    if (const std::optional<AccelCorrection> correction = firmware.get_accel_correction()) {
+        imu.set_accel_correction(*correction);
+    }
+}
+
+#if CONFIG_GYRO_CALIBRATION
+/**
+ * @brief Calibrates the gyroscope bias, warm-starting from the bias stored in NVS, and stores a new one.
+ */
+void calibrate_gyro(IMU &imu)
+{
+    auto &firmware = FirmwareService::get_instance();
+    GyroCalibration calibration({.samples = CONFIG_GYRO_CALIBRATION_SAMPLES,
+                                 .warm_start_samples = CONFIG_GYRO_CALIBRATION_SAMPLES / 5,
+                                 .max_noise_dps = CONFIG_GYRO_CALIBRATION_MAX_NOISE_MDPS / 1000.0f,
+                                 .sample_period_us = MPU6050_CONFIG.get_sample_period_us()});
+    const GyroCalibrationResult result = calibration.run(imu, firmware.get_gyro_bias());
+    if (result.source == GyroCalibrationSource::CALIBRATED) {
+        firmware.set_gyro_bias(result.bias);
+    }
+}
+#endif
+
+/**
+ * @brief Creates the MPU6050 with the configured ranges and filter, corrects its accelerometer and calibrates its
+ * gyroscope, reading through its FIFO and pacing the control loop by its data-ready interrupt if configured.
+ */
+MPU6050 make_imu()
+{
+    MPU6050 imu(MPU6050_ADDRESS, MPU6050_CONFIG);
+    correct_accel(imu);
+#if CONFIG_GYRO_CALIBRATION
+    calibrate_gyro(imu);
+#endif
+#if CONFIG_MPU6050_FIFO
+    imu.enable_fifo();
+#endif
+#if CONFIG_MPU6050_DATA_READY_INT
+    imu.enable_data_ready_interrupt(static_cast<gpio_num_t>(CONFIG_MPU6050_INT_PIN), &wake_control_loop);
+#endif
+    return imu;
+}
+
+/**
+ * @brief Creates the sensors, motors and the flight controller.
+ */
+std::unique_ptr<Controller> make_controller()
+{
+    auto &motor_factory = MotorFactory::get_instance();
+#if CONFIG_FC_STATIC_PIPELINE
+    std::array<BDCMotor, 4> motors = {*motor_factory.make_bdc_motor(GPIO_NUM_1, LEDC_CHANNEL_0),
+                                      *motor_factory.make_bdc_motor(GPIO_NUM_20, LEDC_CHANNEL_1),
+                                      *motor_factory.make_bdc_motor(GPIO_NUM_9, LEDC_CHANNEL_2),
+                                      *motor_factory.make_bdc_motor(GPIO_NUM_7, LEDC_CHANNEL_3)};
+
+    return std::make_unique<Controller>(
+        make_imu(), BMP280(BMP280_ADDRESS, BMP280_CONFIG), ComplementaryFilter(), XMotorMixer(), std::move(motors));
+#else
+    std::array<std::unique_ptr<IMotor>, 4> motors = {motor_factory.make_bdc_motor(GPIO_NUM_1, LEDC_CHANNEL_0),
+                                                     motor_factory.make_bdc_motor(GPIO_NUM_20, LEDC_CHANNEL_1),
+                                                     motor_factory.make_bdc_motor(GPIO_NUM_9, LEDC_CHANNEL_2),
+                                                     motor_factory.make_bdc_motor(GPIO_NUM_7, LEDC_CHANNEL_3)};
+
+    return std::make_unique<Controller>(std::make_unique<MPU6050>(make_imu()),
+                                        std::make_unique<BMP280>(BMP280_ADDRESS, BMP280_CONFIG),
+                                        std::make_unique<ComplementaryFilter>(),
+                                        std::make_unique<XMotorMixer>(),
+                                        std::move(motors));
+#endif
+}
+} // namespace
+
 extern "C" void app_main(void)
 {
-}
\ No newline at end of file
+    // Sensors are created on the flight core, so the interrupt of the I2C driver they install is allocated there
+    // and bus transfers of the control loop do not compete with Wi-Fi interrupts.
+    static std::unique_ptr<Controller> controller;
+    static Task flight_init(FLIGHT_INIT_TASK_NAME.data(),
+                            FLIGHT_INIT_TASK_STACK_SIZE,
+                            TaskPlan::FLIGHT_INIT,
+                            [main_task = xTaskGetCurrentTaskHandle()]() {
+                                controller = make_controller();
+                                xTaskNotifyGive(main_task);
+                            });
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    controller->set_loop_dividers(
+        {.attitude = CONFIG_FC_ATTITUDE_LOOP_DIVIDER, .altitude = CONFIG_FC_ALTITUDE_LOOP_DIVIDER});
+    controller->get_altitude_reference().set_ground_samples(CONFIG_FC_ALTITUDE_ZERO_SAMPLES);
+
+#if CONFIG_MPU6050_DATA_READY_INT
+    static ControlLoop control_loop(*controller, MPU6050_CONFIG.get_sample_rate_hz());
+    s_control_loop.store(&control_loop, std::memory_order_release);
+    control_loop.start(ControlLoopTrigger::EXTERNAL);
+#else
+    static ControlLoop control_loop(*controller);
+    control_loop.start();
+#endif
+
+#if CONFIG_RC_LINK_ENABLED
+    WiFiManager::get_instance(&EventService::get_instance()).init(WIFI_MODE_STA);
+    static CommunicationService radio(std::make_unique<EspNowTransport>(RC_PEER_MAC, CONFIG_WIFI_AP_CHANNEL));
+    radio.set_rx_callback([](const Message &msg) {
+        if (msg.type == MessageType::WRITE) {
+            controller->get_setpoint_channel().publish(to_setpoint(msg, esp_timer_get_time(), s_armed));
+        }
+        else if (msg.type == MessageType::ARM) {
+            s_armed = msg.is_arm_request();
+            if (!s_armed) {
+                // Stop the motors now instead of waiting for the next stick update.
+                controller->get_setpoint_channel().publish({.armed = false, .timestamp_us = esp_timer_get_time()});
+            }
+            ESP_LOGI(TAG.data(), "%s", s_armed ? "Armed" : "Disarmed, motors stopped");
+        }
+        else if (msg.type == MessageType::QNH) {
+            if (const std::optional<float> qnh_pa = to_qnh(msg)) {
+                controller->get_altitude_reference().set_qnh(*qnh_pa);
+            }
+            else {
+                ESP_LOGW(TAG.data(), "Ignoring implausible QNH");
+            }
+        }
+#if CONFIG_ACCEL_CALIBRATION
+        else if (msg.type == MessageType::CALIBRATE_ACCEL) {
+            FirmwareService::get_instance().set_accel_calibration_requested(true);
+            ESP_LOGI(TAG.data(), "Accelerometer calibration requested, reboot to run it");
+        }
+#endif
+    });
+#endif
+
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(STATS_PERIOD_MS));
+
+        const auto stats = control_loop.get_stats();
+        ESP_LOGI(TAG.data(),
+                 "loop: %lu it, %lu overruns, %lu missed, period %lld..%lld us, jitter %lld us, exec %lld us",
+                 stats.iterations,
+                 stats.overruns,
+                 stats.missed_ticks,
+                 stats.min_period_us,
+                 stats.max_period_us,
+                 stats.max_jitter_us,
+                 stats.max_exec_us);
+        control_loop.reset_stats();
+
+        const auto setpoint_stats = controller->get_setpoint_channel().get_stats();
+        ESP_LOGI(TAG.data(),
+                 "setpoints: %lu received, %lu overwritten, latency %ld us (max %ld us)",
+                 setpoint_stats.received,
+                 setpoint_stats.overwritten,
+                 setpoint_stats.last_latency_us,
+                 setpoint_stats.max_latency_us);
+        controller->get_setpoint_channel().reset_stats();
+        I2cDeviceHolder::get_instance().log_stats();
+#if CONFIG_FC_HEAP_GUARD
+        ESP_LOGI(TAG.data(), "heap guard: %lu allocations in the control task", HeapGuard::get_violations());
+#endif
+#if CONFIG_FLIGHT_LOOP_PROFILING
+        controller->get_profiler().log_stats();
+        controller->get_profiler().reset();
+#endif
+    }
+}
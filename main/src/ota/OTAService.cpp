@@ -50,7 +50,7 @@ void OTAService::check_and_update()
     check_call<OTAException>(fetch_ota_info());
 
     if (has_newer_version()) {
-        new Task(TASK_NAME.data(), TASK_STACK_SIZE, [this]() {
+        new Task(TASK_NAME.data(), TASK_STACK_SIZE, TaskPlan::OTA, [this]() {
             ESP_LOGI(TAG.data(), "Update available: %s", m_meta_info.url.c_str());
             perform_update();
         });
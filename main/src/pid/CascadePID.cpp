@@ -0,0 +1,55 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "pch.hpp"
+#include "CascadePID.hpp"
+
+namespace kopter {
+
+CascadePID::CascadePID(std::unique_ptr<PID> angle_pid, std::unique_ptr<PID> rate_pid)
+    : m_angle_pid{angle_pid ? std::move(angle_pid) : std::make_unique<PID>()},
+      m_rate_pid{rate_pid ? std::move(rate_pid) : std::make_unique<PID>()},
+      m_rate_setpoint{0.0f}
+{
+}
+
+void CascadePID::update_angle(float angle)
+{
+    m_angle_pid->update(angle, m_rate_setpoint);
+    m_rate_pid->set_target_point(m_rate_setpoint);
+}
+
+void CascadePID::update_rate(float rate, float &output)
+{
+    m_rate_pid->update(rate, output);
+}
+
+void CascadePID::set_target_angle(float value) noexcept
+{
+    m_angle_pid->set_target_point(value);
+}
+
+PID &CascadePID::get_angle_pid() noexcept
+{
+    return *m_angle_pid;
+}
+
+PID &CascadePID::get_rate_pid() noexcept
+{
+    return *m_rate_pid;
+}
+
+} // namespace kopter
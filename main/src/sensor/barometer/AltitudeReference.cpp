@@ -0,0 +1,115 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "pch.hpp"
+#include "AltitudeReference.hpp"
+
+#include "PressureAltitude.hpp"
+
+namespace kopter {
+
+namespace {
+// Operating range of the BMP280 (datasheet section 1), about 9 km up to 700 m below sea level.
+constexpr float MIN_PRESSURE_PA = 30000.0f;
+constexpr float MAX_PRESSURE_PA = 110000.0f;
+} // namespace
+
+AltitudeReference::AltitudeReference(uint32_t ground_samples) noexcept
+    : m_ground_samples{std::max<uint32_t>(ground_samples, 1)},
+      m_block_count{0},
+      m_block_sum{0.0f},
+      m_altitude{0.0f},
+      m_ground_altitude{0.0f},
+      m_qnh_pa{PressureAltitude::SEA_LEVEL_PRESSURE},
+      m_qnh_altitude{0.0f},
+      m_zeroed{false},
+      m_armed{false},
+      m_requested_qnh_pa{PressureAltitude::SEA_LEVEL_PRESSURE}
+{
+}
+
+std::optional<float> AltitudeReference::update(float pressure) noexcept
+{
+    // NaN fails both comparisons.
+    if (!(pressure >= MIN_PRESSURE_PA && pressure <= MAX_PRESSURE_PA)) {
+        return std::nullopt;
+    }
+
+    const float qnh_pa = m_requested_qnh_pa.load(std::memory_order_relaxed);
+    if (qnh_pa != m_qnh_pa) {
+        m_qnh_pa = qnh_pa;
+        m_qnh_altitude = PressureAltitude::to_altitude(qnh_pa);
+    }
+
+    m_altitude = PressureAltitude::to_altitude(pressure);
+    if (!m_zeroed) {
+        m_ground_altitude = m_altitude;
+        m_zeroed = true;
+    }
+
+    // The block sums offsets from the zero, which stay small, so no precision is lost to the absolute altitude.
+    if (!m_armed) {
+        m_block_sum += m_altitude - m_ground_altitude;
+        if (++m_block_count == m_ground_samples) {
+            fold_block();
+        }
+    }
+    return m_altitude - m_ground_altitude;
+}
+
+void AltitudeReference::set_armed(bool armed) noexcept
+{
+    if (armed && !m_armed && 2 * m_block_count >= m_ground_samples) {
+        fold_block();
+    }
+    if (armed != m_armed) {
+        m_block_sum = 0.0f;
+        m_block_count = 0;
+    }
+    m_armed = armed;
+}
+
+void AltitudeReference::set_ground_samples(uint32_t ground_samples) noexcept
+{
+    m_ground_samples = std::max<uint32_t>(ground_samples, 1);
+    m_block_sum = 0.0f;
+    m_block_count = 0;
+}
+
+void AltitudeReference::set_qnh(float qnh_pa) noexcept
+{
+    m_requested_qnh_pa.store(qnh_pa, std::memory_order_relaxed);
+}
+
+float AltitudeReference::get_altitude_amsl() const noexcept
+{
+    return m_altitude - m_qnh_altitude;
+}
+
+float AltitudeReference::get_ground_elevation() const noexcept
+{
+    return m_ground_altitude - m_qnh_altitude;
+}
+
+void AltitudeReference::fold_block() noexcept
+{
+    m_ground_altitude += m_block_sum / static_cast<float>(m_block_count);
+    m_block_sum = 0.0f;
+    m_block_count = 0;
+}
+
+} // namespace kopter
@@ -27,4 +27,9 @@ const char *IBarometer::get_name() const noexcept
     return "[IBarometer]";
 }
 
+bool IBarometer::has_new_sample() const noexcept
+{
+    return true;
+}
+
 } // namespace kopter
\ No newline at end of file
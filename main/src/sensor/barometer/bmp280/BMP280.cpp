@@ -20,26 +20,47 @@
 #include "ByteUtils.hpp"
 #include "I2cDeviceHolder.hpp"
 
+#include "esp_timer.h"
+#include "freertos/task.h"
+
+#include <cassert>
+
 namespace kopter {
 
 namespace {
 constexpr uint8_t CTRL_MEAS_REG = 0xF4;
 constexpr uint8_t CONFIG_REG = 0xF5;
-constexpr uint8_t TEMP_UPPER_BYTE = 0xFA;
 constexpr uint8_t PRESSURE_UPPER_BYTE = 0xF7;
 constexpr uint8_t CALIB_UPPER_BYTE = 0x88;
 constexpr uint8_t TEMP_BYTES = 3;
 constexpr uint8_t PRESSURE_BYTES = 3;
+constexpr uint8_t MEASUREMENT_BYTES = PRESSURE_BYTES + TEMP_BYTES; // 0xF7..0xFC, pressure first
 constexpr uint8_t CALIB_BYTES = 24;
+
+// In normal mode reads fall due 1/32 of the conversion period early, so a sensor clock faster than nominal cannot
+// make the driver skip a conversion. A read that still sees the cached conversion polls again after
+// `POLL_INTERVAL_US`.
+constexpr int64_t EARLY_READ_DIVIDER = 32;
+constexpr int64_t POLL_INTERVAL_US = 1000;
+
+// Reading of a skipped measurement (datasheet section 3.3.2), also held from power-up until the first conversion.
+constexpr uint32_t SKIPPED_READING = 0x80000;
+
+// Readings are 20 bits, MSB first and left-aligned in three registers.
+constexpr uint32_t get_u20(uint8_t msb, uint8_t lsb, uint8_t xlsb)
+{
+    return ((static_cast<uint32_t>(msb) << 16) | (static_cast<uint32_t>(lsb) << 8) | xlsb) >> 4;
+}
 } // namespace
 
-BMP280::BMP280(uint8_t address)
-    : IBarometer(), m_mapper{std::make_unique<BMP280Mapper>()}, m_calib{std::make_unique<BMP280Calibration>()}
+BMP280::BMP280(uint8_t address, const BMP280Config &config)
+    : IBarometer(),
+      m_i2c_device{I2cDeviceHolder::get_instance().add_device("BMP280", address, I2cPriority::BAROMETER)},
+      m_mapper{std::make_unique<BMP280Mapper>()},
+      m_calib{std::make_unique<BMP280Calibration>()}
 {
-    m_i2c_device.reset(I2cDeviceHolder::get_instance().add_device("BMP280", address));
     assert(m_i2c_device);
-    set_ctrl_meas();
-    set_config();
+    set_config(config);
     set_calib_data();
 }
 
@@ -50,46 +71,105 @@ const char *BMP280::get_name() const noexcept
 
 float BMP280::read_temperature()
 {
-    auto result = m_i2c_device->read(TEMP_UPPER_BYTE, TEMP_BYTES);
-    int32_t raw = ((static_cast<int32_t>(result[0]) << 16) | (static_cast<int32_t>(result[1]) << 8) | result[2]) >> 4;
-
-    return m_mapper->map_temperature(raw, m_calib.get());
+    update();
+    return m_measurement.temperature;
 }
 
 float BMP280::read_pressure()
 {
-    auto result = m_i2c_device->read(PRESSURE_UPPER_BYTE, PRESSURE_BYTES);
-    uint32_t raw =
-        ((static_cast<uint32_t>(result[0]) << 16) | (static_cast<uint32_t>(result[1]) << 8) | result[2]) >> 4;
-
-    return m_mapper->map_pressure(raw, m_calib.get());
+    update();
+    return m_measurement.pressure;
 }
 
 float BMP280::read_altitude()
 {
-    auto temp = read_temperature();
-    auto pressure = read_pressure();
+    update();
+    return m_altitude;
+}
+
+bool BMP280::has_new_sample() const noexcept
+{
+    return m_new_sample;
+}
 
-    return m_mapper->map_altitude(pressure);
+void BMP280::set_config(const BMP280Config &config)
+{
+    BMP280Config sleep = config;
+    sleep.mode = BMP280Mode::SLEEP;
+    m_i2c_device->write(CTRL_MEAS_REG, sleep.get_ctrl_meas());
+    m_i2c_device->write(CONFIG_REG, config.get_config());
+    if (config.mode == BMP280Mode::NORMAL) {
+        m_i2c_device->write(CTRL_MEAS_REG, config.get_ctrl_meas());
+    }
+
+    m_config = config;
+    m_conversion_pending = false;
+    m_next_read_us = 0;
+    if (config.mode == BMP280Mode::FORCED && m_raw == NO_READING) {
+        start_conversion(esp_timer_get_time());
+        // One tick more than the measurement time, as `vTaskDelay` may return right at the next tick.
+        const int64_t ticks = (config.get_max_measurement_time_us() * configTICK_RATE_HZ + 999999) / 1000000;
+        vTaskDelay(static_cast<TickType_t>(ticks + 1));
+        m_next_read_us = 0;
+    }
+}
+
+const BMP280Config &BMP280::get_config() const noexcept
+{
+    return m_config;
 }
 
-void BMP280::set_ctrl_meas()
+void BMP280::update()
 {
-    // Temperature oversampling - Ultra low (x1)
-    // Pressure oversampling - Standard resolution (x4)
-    // Power mode - Normal
-    m_i2c_device->write({CTRL_MEAS_REG, 0x2F});
+    m_new_sample = false;
+    const int64_t now_us = esp_timer_get_time();
+    if (m_config.mode == BMP280Mode::SLEEP || now_us < m_next_read_us) {
+        return;
+    }
+
+    const bool forced = m_config.mode == BMP280Mode::FORCED;
+    if (forced && !m_conversion_pending) {
+        start_conversion(now_us);
+        return;
+    }
+
+    std::array<uint8_t, MEASUREMENT_BYTES> result;
+    m_i2c_device->read(PRESSURE_UPPER_BYTE, result);
+    const BMP280RawFrame raw{.temperature = static_cast<int32_t>(get_u20(result[3], result[4], result[5])),
+                             .pressure = get_u20(result[0], result[1], result[2])};
+    // The next conversion has not landed yet. Two conversions with identical readings are rare and only cost
+    // polling until the one after. A forced conversion is complete after its longest measurement time. Before the
+    // first conversion after power-up the registers hold the skipped reading, which would compensate to a plausible
+    // pressure about 1.7 km off.
+    const bool skipped = raw.pressure == SKIPPED_READING || raw.temperature == static_cast<int32_t>(SKIPPED_READING);
+    if (skipped || (!forced && raw == m_raw)) {
+        m_next_read_us = now_us + POLL_INTERVAL_US;
+        return;
+    }
+
+    m_raw = raw;
+    m_measurement = m_mapper->map(raw, m_calib.get());
+    m_altitude = m_mapper->map_altitude(m_measurement.pressure);
+    m_new_sample = true;
+    if (forced) {
+        start_conversion(now_us);
+        return;
+    }
+    const int64_t period_us = m_config.get_conversion_period_us();
+    m_next_read_us = now_us + period_us - period_us / EARLY_READ_DIVIDER;
 }
 
-void BMP280::set_config()
+void BMP280::start_conversion(int64_t now_us)
 {
-    // standby - 62.5ms, IIR filter - 4, SPI - off
-    m_i2c_device->write({CONFIG_REG, 0x26});
+    m_i2c_device->write(CTRL_MEAS_REG, m_config.get_ctrl_meas());
+    m_conversion_pending = true;
+    m_next_read_us = now_us + m_config.get_max_measurement_time_us();
 }
 
 void BMP280::set_calib_data()
 {
-    auto result = m_i2c_device->read(CALIB_UPPER_BYTE, CALIB_BYTES);
+    std::array<uint8_t, CALIB_BYTES> result;
+    m_i2c_device->read(CALIB_UPPER_BYTE, result);
     m_calib->dig_T1 = ByteUtils::get_u16_le(result[0], result[1]);
     m_calib->dig_T2 = ByteUtils::get_s16_le(result[2], result[3]);
     m_calib->dig_T3 = ByteUtils::get_s16_le(result[4], result[5]);
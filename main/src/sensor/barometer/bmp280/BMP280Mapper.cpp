@@ -16,16 +16,12 @@
 
 #include "BMP280Mapper.hpp"
 
-#include <cmath>
+#include "PressureAltitude.hpp"
 
 namespace kopter {
 
 namespace {
-constexpr float SEA_LEVEL_PRESSURE = 101325.0f;
-constexpr float ALTITUDE_SCALE = 44330.0f;
-constexpr float ALTITUDE_EXPONENT = 0.1903f;
-constexpr float HPA2PA =
-    1.0f / 2.560f; // Convert BMP280 raw compensated output to Pa (final formula: Pa = raw * HPA2PA)
+constexpr float Q24_8_TO_PA = 1.0f / 256.0f; // The compensated pressure is Q24.8 Pa
 } // namespace
 
 BMP280Mapper::BMP280Mapper() : m_t_fine{0}
@@ -42,9 +38,15 @@ float BMP280Mapper::map_pressure(uint32_t raw, BMP280Calibration *calib)
     return get_compensated_pressure(raw, calib);
 }
 
+BMP280Measurement BMP280Mapper::map(const BMP280RawFrame &raw, BMP280Calibration *calib)
+{
+    const float temperature = get_compensated_temperature(raw.temperature, calib);
+    return {.temperature = temperature, .pressure = get_compensated_pressure(raw.pressure, calib)};
+}
+
 float BMP280Mapper::map_altitude(float pressure)
 {
-    return ALTITUDE_SCALE * (1.0f - std::pow(pressure / SEA_LEVEL_PRESSURE, ALTITUDE_EXPONENT));
+    return PressureAltitude::to_altitude(pressure);
 }
 
 float BMP280Mapper::get_compensated_temperature(int32_t adc_t, BMP280Calibration *calib)
@@ -90,13 +92,12 @@ float BMP280Mapper::get_compensated_pressure(uint32_t adc_p, BMP280Calibration *
     }
 
     int64_t pressure = 1048576 - adc_p;
-    pressure = ((pressure * 3125) / var1);
+    pressure = (((pressure << 31) - var2) * 3125) / var1;
     var1 = (dig_P9 * (pressure >> 13) * (pressure >> 13)) >> 25;
     var2 = (dig_P8 * pressure) >> 19;
     pressure = ((pressure + var1 + var2) >> 8) + (dig_P7 << 4);
-    pressure = static_cast<uint32_t>(pressure);
 
-    return static_cast<float>(pressure) * HPA2PA;
+    return static_cast<float>(static_cast<uint32_t>(pressure)) * Q24_8_TO_PA;
 }
 
 } // namespace kopter
\ No newline at end of file
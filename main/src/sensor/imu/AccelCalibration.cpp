@@ -0,0 +1,182 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "pch.hpp"
+#include "AccelCalibration.hpp"
+
+#include "RunningStats.hpp"
+#include "SamplePacer.hpp"
+
+#include "freertos/task.h"
+
+#include <cmath>
+
+namespace kopter {
+
+namespace {
+constexpr size_t UNKNOWNS = 4; // one row of the matrix and the offset of that axis
+constexpr double MIN_PIVOT = 1e-6;
+constexpr uint32_t REMIND_EVERY_ATTEMPTS = 20;
+constexpr std::array<const char *, AccelCalibration::ORIENTATION_COUNT> INSTRUCTIONS{
+    "flat, Z up", "upside down, Z down", "on its edge, X up", "on its edge, X down", "on its edge, Y up",
+    "on its edge, Y down"};
+constexpr std::string_view TAG = "[AccelCalibration]";
+} // namespace
+
+AccelCalibration::AccelCalibration(const AccelCalibrationConfig &config) : m_config{config}
+{
+}
+
+std::optional<AccelCorrection> AccelCalibration::run(IMU &imu)
+{
+    imu.set_accel_correction({});
+
+    std::array<glm::vec3, ORIENTATION_COUNT> measured;
+    for (size_t i = 0; i != ORIENTATION_COUNT; ++i) {
+        const std::optional<glm::vec3> reading = capture(imu, static_cast<AccelOrientation>(i));
+        if (!reading) {
+            ESP_LOGE(TAG.data(), "Timed out waiting for the board %s", INSTRUCTIONS[i]);
+            return std::nullopt;
+        }
+        measured[i] = *reading;
+    }
+
+    const std::optional<AccelCorrection> correction = solve(measured);
+    if (!correction) {
+        ESP_LOGE(TAG.data(), "Readings do not span all axes");
+        return std::nullopt;
+    }
+
+    imu.set_accel_correction(*correction);
+    ESP_LOGI(TAG.data(),
+             "Scale (%.4f, %.4f, %.4f), offset (%.4f, %.4f, %.4f) g",
+             correction->matrix[0][0],
+             correction->matrix[1][1],
+             correction->matrix[2][2],
+             correction->offset[0],
+             correction->offset[1],
+             correction->offset[2]);
+    return correction;
+}
+
+std::optional<AccelCorrection> AccelCalibration::solve(const std::array<glm::vec3, ORIENTATION_COUNT> &measured)
+{
+    // Each row r of [M | c] minimizes sum (M_r . m + c_r - g_r)^2 over the readings. All three rows share the normal
+    // matrix sum a a^T with a = (m, 1), so one elimination solves them together: columns 0..3 of `system` hold the
+    // normal matrix, columns 4..6 the right-hand sides sum a g_r. Double precision, the readings are around 1 g.
+    std::array<std::array<double, UNKNOWNS + 3>, UNKNOWNS> system{};
+    for (size_t i = 0; i != ORIENTATION_COUNT; ++i) {
+        const glm::vec3 &m = measured[i];
+        const glm::vec3 g = get_expected(static_cast<AccelOrientation>(i));
+        const std::array<double, UNKNOWNS> a{m.x, m.y, m.z, 1.0};
+        for (size_t row = 0; row != UNKNOWNS; ++row) {
+            for (size_t col = 0; col != UNKNOWNS; ++col) {
+                system[row][col] += a[row] * a[col];
+            }
+            for (size_t axis = 0; axis != 3; ++axis) {
+                system[row][UNKNOWNS + axis] += a[row] * g[axis];
+            }
+        }
+    }
+
+    // Gauss-Jordan elimination with partial pivoting.
+    for (size_t col = 0; col != UNKNOWNS; ++col) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row != UNKNOWNS; ++row) {
+            if (std::abs(system[row][col]) > std::abs(system[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (std::abs(system[pivot][col]) < MIN_PIVOT) {
+            return std::nullopt;
+        }
+        std::swap(system[col], system[pivot]);
+
+        for (size_t row = 0; row != UNKNOWNS; ++row) {
+            if (row == col) {
+                continue;
+            }
+            const double factor = system[row][col] / system[col][col];
+            for (size_t k = col; k != UNKNOWNS + 3; ++k) {
+                system[row][k] -= factor * system[col][k];
+            }
+        }
+    }
+
+    // Unknown j of output axis r is system[j][UNKNOWNS + r] / system[j][j].
+    AccelCorrection correction;
+    for (size_t axis = 0; axis != 3; ++axis) {
+        for (size_t j = 0; j != 3; ++j) {
+            correction.matrix[axis][j] = static_cast<float>(system[j][UNKNOWNS + axis] / system[j][j]);
+        }
+        correction.offset[axis] = static_cast<float>(system[3][UNKNOWNS + axis] / system[3][3]);
+    }
+    return correction;
+}
+
+glm::vec3 AccelCalibration::get_expected(AccelOrientation orientation) noexcept
+{
+    switch (orientation) {
+    case AccelOrientation::Z_UP:
+        return {0.0f, 0.0f, 1.0f};
+    case AccelOrientation::Z_DOWN:
+        return {0.0f, 0.0f, -1.0f};
+    case AccelOrientation::X_UP:
+        return {1.0f, 0.0f, 0.0f};
+    case AccelOrientation::X_DOWN:
+        return {-1.0f, 0.0f, 0.0f};
+    case AccelOrientation::Y_UP:
+        return {0.0f, 1.0f, 0.0f};
+    default:
+        return {0.0f, -1.0f, 0.0f};
+    }
+}
+
+std::optional<glm::vec3> AccelCalibration::capture(IMU &imu, AccelOrientation orientation)
+{
+    const size_t index = static_cast<size_t>(orientation);
+    const glm::vec3 expected = get_expected(orientation);
+
+    for (uint32_t attempt = 0; attempt != m_config.max_attempts; ++attempt) {
+        if (attempt % REMIND_EVERY_ATTEMPTS == 0) {
+            ESP_LOGI(TAG.data(), "%zu/%zu: rest the board %s", index + 1, ORIENTATION_COUNT, INSTRUCTIONS[index]);
+        }
+
+        RunningStats x;
+        RunningStats y;
+        RunningStats z;
+        SamplePacer pacer(m_config.sample_period_us);
+        for (uint32_t i = 0; i != m_config.samples; ++i) {
+            pacer.wait();
+
+            const IMUData data = imu.get_data();
+            x.add(data.ax);
+            y.add(data.ay);
+            z.add(data.az);
+        }
+
+        const glm::vec3 mean(x.mean, y.mean, z.mean);
+        const bool still = std::max({x.get_std(), y.get_std(), z.get_std()}) <= m_config.max_noise_g;
+        if (still && glm::dot(mean, expected) >= m_config.min_alignment_g) {
+            return mean;
+        }
+        vTaskDelay(pdMS_TO_TICKS(m_config.retry_delay_ms));
+    }
+    return std::nullopt;
+}
+
+} // namespace kopter
@@ -0,0 +1,132 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "pch.hpp"
+#include "GyroCalibration.hpp"
+
+#include "RunningStats.hpp"
+#include "SamplePacer.hpp"
+
+#include <cmath>
+
+namespace kopter {
+
+namespace {
+constexpr std::string_view TAG = "[GyroCalibration]";
+
+const char *to_string(GyroCalibrationSource source)
+{
+    switch (source) {
+    case GyroCalibrationSource::CALIBRATED:
+        return "calibrated";
+    case GyroCalibrationSource::WARM_START:
+        return "warm start";
+    case GyroCalibrationSource::STORED_FALLBACK:
+        return "stored, unconfirmed";
+    default:
+        return "none";
+    }
+}
+} // namespace
+
+GyroCalibration::GyroCalibration(const GyroCalibrationConfig &config) : m_config{config}
+{
+}
+
+GyroCalibrationResult GyroCalibration::run(IMU &imu, const std::optional<GyroBias> &stored)
+{
+    imu.set_gyro_bias({});
+    GyroCalibrationResult result{
+        .bias = {}, .source = GyroCalibrationSource::NONE, .noise_dps = 0.0f, .sample_count = 0};
+
+    if (stored && m_config.warm_start_samples > 0) {
+        const Window window = sample(imu, m_config.warm_start_samples);
+        result.sample_count += m_config.warm_start_samples;
+        result.noise_dps = window.noise_dps;
+        if (confirms(window, *stored)) {
+            result.bias = *stored;
+            result.source = GyroCalibrationSource::WARM_START;
+        }
+    }
+
+    for (uint32_t attempt = 0; result.source == GyroCalibrationSource::NONE && attempt != m_config.max_attempts;
+         ++attempt) {
+        const Window window = sample(imu, m_config.samples);
+        result.sample_count += m_config.samples;
+        result.noise_dps = window.noise_dps;
+        if (is_still(window)) {
+            result.bias = window.mean;
+            result.source = GyroCalibrationSource::CALIBRATED;
+        }
+        else {
+            ESP_LOGW(TAG.data(), "Moved during calibration (noise %.2f deg/s), retrying", window.noise_dps);
+        }
+    }
+
+    if (result.source == GyroCalibrationSource::NONE && stored) {
+        result.bias = *stored;
+        result.source = GyroCalibrationSource::STORED_FALLBACK;
+    }
+
+    imu.set_gyro_bias(result.bias);
+    ESP_LOGI(TAG.data(),
+             "Bias (%.3f, %.3f, %.3f) deg/s at %.1f C, %s after %lu samples",
+             result.bias.gx,
+             result.bias.gy,
+             result.bias.gz,
+             result.bias.temperature,
+             to_string(result.source),
+             static_cast<unsigned long>(result.sample_count));
+    return result;
+}
+
+GyroCalibration::Window GyroCalibration::sample(IMU &imu, uint32_t count)
+{
+    RunningStats gx;
+    RunningStats gy;
+    RunningStats gz;
+    RunningStats temperature;
+    // Reading faster than the sensor samples would count the same sample twice and understate the noise.
+    SamplePacer pacer(m_config.sample_period_us);
+    for (uint32_t i = 0; i != count; ++i) {
+        pacer.wait();
+
+        const IMUData data = imu.get_data();
+        gx.add(data.gx);
+        gy.add(data.gy);
+        gz.add(data.gz);
+        temperature.add(data.temperature);
+    }
+
+    return {.mean = {.gx = gx.mean, .gy = gy.mean, .gz = gz.mean, .temperature = temperature.mean},
+            .noise_dps = std::max({gx.get_std(), gy.get_std(), gz.get_std()})};
+}
+
+bool GyroCalibration::is_still(const Window &window) const noexcept
+{
+    return window.noise_dps <= m_config.max_noise_dps;
+}
+
+bool GyroCalibration::confirms(const Window &window, const GyroBias &stored) const noexcept
+{
+    const float tolerance = m_config.warm_start_tolerance_dps;
+    return is_still(window) && std::fabs(window.mean.gx - stored.gx) <= tolerance &&
+           std::fabs(window.mean.gy - stored.gy) <= tolerance && std::fabs(window.mean.gz - stored.gz) <= tolerance &&
+           std::fabs(window.mean.temperature - stored.temperature) <= m_config.warm_start_max_temperature_delta;
+}
+
+} // namespace kopter
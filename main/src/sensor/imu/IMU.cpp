@@ -28,4 +28,14 @@ const char *IMU::get_name() const noexcept
     return "[IMU]";
 }
 
+size_t IMU::read_batch(std::span<IMUData> samples)
+{
+    if (samples.empty()) {
+        return 0;
+    }
+
+    samples[0] = get_data();
+    return 1;
+}
+
 } // namespace kopter
\ No newline at end of file
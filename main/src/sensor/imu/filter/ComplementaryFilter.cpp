@@ -66,8 +66,8 @@ void ComplementaryFilter::apply_gyro_influence(float gx, float gy, float gz, flo
 void ComplementaryFilter::apply_accel_influence(float ax, float ay, float az, float dt)
 {
     glm::vec3 accel = glm::normalize(glm::vec3(ax, ay, az));
-    float pitch = std::atan2f(-accel.x, sqrtf(accel.y * accel.y + accel.z * accel.z));
-    float roll = std::atan2f(accel.y, accel.z);
+    float pitch = std::atan2(-accel.x, std::sqrt(accel.y * accel.y + accel.z * accel.z));
+    float roll = std::atan2(accel.y, accel.z);
     glm::quat accel_quat = glm::angleAxis(roll, glm::vec3(1, 0, 0)) * glm::angleAxis(pitch, glm::vec3(0, 1, 0));
     m_quat = glm::normalize(glm::slerp(m_quat, accel_quat, 1.0f - m_alpha));
 }
@@ -17,36 +17,85 @@
 #include "pch.hpp"
 #include "MPU6050.hpp"
 
+#include "ByteUtils.hpp"
 #include "I2cDeviceHolder.hpp"
 
+#include "esp_timer.h"
+#include "freertos/task.h"
+
+#include <cassert>
+
 namespace kopter {
 
 namespace {
 constexpr uint8_t POWER_MGT_REG = 0x6B;
 constexpr uint8_t DEVICE_RESET = 0x01;
 constexpr uint8_t SLEEP_MODE = 0x00;
-constexpr uint8_t ACCEL_CONFIG_REG = 0x1C;
-constexpr uint8_t GYRO_CONFIG_REG = 0x1B;
-constexpr uint8_t ACCEL_2G = 0x00;
-constexpr uint8_t GYRO_250DPS = 0x00;
+constexpr uint8_t SMPLRT_DIV_REG = 0x19; // followed by CONFIG, GYRO_CONFIG and ACCEL_CONFIG
+constexpr uint8_t FS_SEL_SHIFT = 3;
+constexpr uint8_t FIFO_EN_REG = 0x23;
+constexpr uint8_t FIFO_EN_ALL = 0xF8; // temperature, gyro X/Y/Z and accel, stored in data register order
+constexpr uint8_t USER_CTRL_REG = 0x6A;
+constexpr uint8_t USER_CTRL_FIFO_EN = 0x40;
+constexpr uint8_t USER_CTRL_FIFO_RESET = 0x04;
+constexpr uint8_t FIFO_COUNT_H_REG = 0x72;
+constexpr uint8_t FIFO_R_W_REG = 0x74;
+constexpr uint8_t INT_PIN_CFG_REG = 0x37;
+constexpr uint8_t INT_PULSE_ACTIVE_HIGH = 0x10; // push-pull, 50 us pulse, status cleared by any read
+constexpr uint8_t INT_ENABLE_REG = 0x38;
+constexpr uint8_t DATA_RDY_EN = 0x01;
+constexpr uint16_t FIFO_SIZE = 1024;
 constexpr uint8_t REG_AX_H = 0x3B;
-constexpr uint8_t REG_AY_H = 0x3D;
-constexpr uint8_t REG_AZ_H = 0x3F;
-constexpr uint8_t REG_GX_H = 0x43;
-constexpr uint8_t REG_GY_H = 0x45;
-constexpr uint8_t REG_GZ_H = 0x47;
-constexpr uint8_t BYTES_PER_AXIS = 2;
+constexpr uint8_t FRAME_BYTES = 14;
+constexpr uint8_t AX_INDEX = 0;
+constexpr uint8_t AY_INDEX = 2;
+constexpr uint8_t AZ_INDEX = 4;
+constexpr uint8_t TEMP_INDEX = 6;
+constexpr uint8_t GX_INDEX = 8;
+constexpr uint8_t GY_INDEX = 10;
+constexpr uint8_t GZ_INDEX = 12;
 constexpr uint8_t DELAY_MS = 100;
+
+/**
+ * @brief Returns the GYRO_CONFIG or ACCEL_CONFIG value selecting a full-scale range.
+ */
+template <typename Range> constexpr uint8_t to_fs_sel(Range range)
+{
+    return static_cast<uint8_t>(static_cast<uint8_t>(range) << FS_SEL_SHIFT);
+}
+
+/**
+ * @brief Decodes a frame of the data registers or of the FIFO, which share the same layout.
+ */
+IMUData decode_frame(const MPU6050Mapper &mapper, const uint8_t *frame)
+{
+    auto raw = [frame](uint8_t offset) { return ByteUtils::get_s16_be(frame[offset], frame[offset + 1]); };
+    return mapper.map({.ax = raw(AX_INDEX),
+                       .ay = raw(AY_INDEX),
+                       .az = raw(AZ_INDEX),
+                       .temperature = raw(TEMP_INDEX),
+                       .gx = raw(GX_INDEX),
+                       .gy = raw(GY_INDEX),
+                       .gz = raw(GZ_INDEX)});
+}
 } // namespace
 
-MPU6050::MPU6050(uint8_t address) : IMU(), m_mapper{std::make_unique<MPU6050Mapper>()}
+MPU6050::MPU6050(uint8_t address, const MPU6050Config &config)
+    : IMU(),
+      m_i2c_device{I2cDeviceHolder::get_instance().add_device("MPU6050", address, I2cPriority::IMU)},
+      m_mapper{std::make_unique<MPU6050Mapper>()}
 {
-    m_i2c_device.reset(I2cDeviceHolder::get_instance().add_device("MPU6050", address));
     assert(m_i2c_device);
-    set_config();
+    reset();
+    set_config(config);
 }
 
-MPU6050::~MPU6050() = default;
+MPU6050::~MPU6050()
+{
+    if (m_data_ready) {
+        gpio_isr_handler_remove(m_data_ready->pin);
+    }
+}
 
 const char *MPU6050::get_name() const noexcept
 {
@@ -55,61 +104,178 @@ const char *MPU6050::get_name() const noexcept
 
 IMUData MPU6050::get_data()
 {
-    return {read_gx(), read_gy(), read_gz(), read_ax(), read_ay(), read_az()};
+    std::array<uint8_t, FRAME_BYTES> frame;
+    m_i2c_device->read(REG_AX_H, frame);
+
+    IMUData data = decode_frame(*m_mapper, frame.data());
+    data.timestamp_us = get_sample_time(esp_timer_get_time());
+    return data;
 }
 
-float MPU6050::read_ax() const
+size_t MPU6050::read_batch(std::span<IMUData> samples)
 {
-    auto raw = get_raw_value(REG_AX_H);
-    return m_mapper->map_accel_x(raw);
+    if (!m_fifo_enabled) {
+        return IMU::read_batch(samples);
+    }
+
+    std::array<uint8_t, 2> count_bytes;
+    m_i2c_device->read(FIFO_COUNT_H_REG, count_bytes);
+    const int64_t newest_us = get_sample_time(esp_timer_get_time());
+    const uint16_t count = ByteUtils::get_u16_be(count_bytes[0], count_bytes[1]);
+
+    // Once the next frame no longer fits, the sensor overwrites the oldest bytes and frames lose their alignment.
+    if (count + FRAME_BYTES > FIFO_SIZE) {
+        ++m_fifo_overflows;
+        reset_fifo();
+        return 0;
+    }
+
+    const size_t buffered = count / FRAME_BYTES;
+    const int64_t sample_period_us = m_config.get_sample_period_us();
+    const size_t frames = std::min({buffered, samples.size(), IMU::MAX_BATCH});
+    if (frames == 0) {
+        return 0;
+    }
+
+    std::array<uint8_t, IMU::MAX_BATCH * FRAME_BYTES> fifo;
+    m_i2c_device->read(FIFO_R_W_REG, std::span<uint8_t>(fifo.data(), frames * FRAME_BYTES));
+
+    for (size_t i = 0; i != frames; ++i) {
+        samples[i] = decode_frame(*m_mapper, fifo.data() + i * FRAME_BYTES);
+        samples[i].timestamp_us = newest_us - static_cast<int64_t>(buffered - 1 - i) * sample_period_us;
+    }
+    return frames;
 }
 
-float MPU6050::read_ay() const
+void MPU6050::set_config(const MPU6050Config &config)
 {
-    auto raw = get_raw_value(REG_AY_H);
-    return m_mapper->map_accel_y(raw);
+    const std::array<uint8_t, 4> registers{config.sample_rate_divider,
+                                           static_cast<uint8_t>(config.dlpf),
+                                           to_fs_sel(config.gyro_range),
+                                           to_fs_sel(config.accel_range)};
+    m_i2c_device->write(SMPLRT_DIV_REG, registers);
+    MPU6050Mapper mapper(config.accel_range, config.gyro_range);
+    mapper.set_gyro_bias(m_mapper->get_gyro_bias());
+    mapper.set_accel_correction(m_mapper->get_accel_correction());
+    *m_mapper = mapper;
+    m_config = config;
+
+    if (m_fifo_enabled) {
+        reset_fifo();
+    }
 }
 
-float MPU6050::read_az() const
+void MPU6050::set_gyro_bias(const GyroBias &bias) noexcept
 {
-    auto raw = get_raw_value(REG_AZ_H);
-    return m_mapper->map_accel_z(raw);
+    m_mapper->set_gyro_bias(bias);
 }
 
-float MPU6050::read_gx() const
+void MPU6050::set_accel_correction(const AccelCorrection &correction) noexcept
 {
-    auto raw = get_raw_value(REG_GX_H);
-    return m_mapper->map_gyro_x(raw);
+    m_mapper->set_accel_correction(correction);
 }
 
-float MPU6050::read_gy() const
+const MPU6050Config &MPU6050::get_config() const noexcept
 {
-    auto raw = get_raw_value(REG_GY_H);
-    return m_mapper->map_gyro_y(raw);
+    return m_config;
 }
 
-float MPU6050::read_gz() const
+void MPU6050::enable_fifo()
 {
-    auto raw = get_raw_value(REG_GZ_H);
-    return m_mapper->map_gyro_z(raw);
+    m_i2c_device->write(FIFO_EN_REG, FIFO_EN_ALL);
+    reset_fifo();
+    m_fifo_enabled = true;
 }
 
-int16_t MPU6050::get_raw_value(uint8_t reg) const
+uint32_t MPU6050::get_fifo_overflows() const noexcept
 {
-    auto result = m_i2c_device->read(reg, BYTES_PER_AXIS);
-    int16_t raw = static_cast<int16_t>((result[0] << 8) | result[1]);
+    return m_fifo_overflows;
+}
 
-    return raw;
+void MPU6050::enable_data_ready_interrupt(gpio_num_t pin, DataReadyCallback callback, void *context)
+{
+    m_i2c_device->write(INT_PIN_CFG_REG, INT_PULSE_ACTIVE_HIGH);
+
+    if (m_data_ready) {
+        gpio_isr_handler_remove(m_data_ready->pin);
+    }
+    // The state lives on the heap so the ISR argument stays valid when the driver is moved.
+    m_data_ready = std::make_unique<DataReadyState>();
+    m_data_ready->pin = pin;
+    m_data_ready->callback = callback;
+    m_data_ready->context = context;
+    portMUX_INITIALIZE(&m_data_ready->lock);
+
+    gpio_config_t io_config{};
+    io_config.pin_bit_mask = 1ULL << pin;
+    io_config.mode = GPIO_MODE_INPUT;
+    io_config.pull_up_en = GPIO_PULLUP_DISABLE;
+    io_config.pull_down_en = GPIO_PULLDOWN_ENABLE;
+    io_config.intr_type = GPIO_INTR_POSEDGE;
+    check_call<KopterException>(gpio_config(&io_config));
+
+    // The service may already be installed by another driver.
+    const esp_err_t err = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+    if (err != ESP_ERR_INVALID_STATE) {
+        check_call<KopterException>(err);
+    }
+    check_call<KopterException>(gpio_isr_handler_add(pin, &MPU6050::on_data_ready, m_data_ready.get()));
+
+    m_i2c_device->write(INT_ENABLE_REG, DATA_RDY_EN);
+}
+
+uint32_t MPU6050::get_data_ready_count() const noexcept
+{
+    if (!m_data_ready) {
+        return 0;
+    }
+
+    taskENTER_CRITICAL(&m_data_ready->lock);
+    const uint32_t count = m_data_ready->count;
+    taskEXIT_CRITICAL(&m_data_ready->lock);
+    return count;
 }
 
-void MPU6050::set_config()
+void MPU6050::reset()
 {
-    m_i2c_device->write({POWER_MGT_REG, DEVICE_RESET});
+    m_i2c_device->write(POWER_MGT_REG, DEVICE_RESET);
     vTaskDelay(pdMS_TO_TICKS(DELAY_MS));
-    m_i2c_device->write({POWER_MGT_REG, SLEEP_MODE});
+    m_i2c_device->write(POWER_MGT_REG, SLEEP_MODE);
     vTaskDelay(pdMS_TO_TICKS(DELAY_MS));
-    m_i2c_device->write({ACCEL_CONFIG_REG, ACCEL_2G});
-    m_i2c_device->write({GYRO_CONFIG_REG, GYRO_250DPS});
 }
 
-} // namespace kopter
\ No newline at end of file
+void MPU6050::reset_fifo()
+{
+    // FIFO_RESET only takes effect while FIFO_EN is cleared.
+    m_i2c_device->write(USER_CTRL_REG, USER_CTRL_FIFO_RESET);
+    m_i2c_device->write(USER_CTRL_REG, USER_CTRL_FIFO_EN);
+}
+
+int64_t MPU6050::get_sample_time(int64_t fallback_us) const noexcept
+{
+    if (!m_data_ready) {
+        return fallback_us;
+    }
+
+    taskENTER_CRITICAL(&m_data_ready->lock);
+    const int64_t timestamp_us = m_data_ready->timestamp_us;
+    taskEXIT_CRITICAL(&m_data_ready->lock);
+    return timestamp_us;
+}
+
+void IRAM_ATTR MPU6050::on_data_ready(void *arg)
+{
+    auto *state = static_cast<DataReadyState *>(arg);
+    const int64_t now_us = esp_timer_get_time();
+
+    taskENTER_CRITICAL_ISR(&state->lock);
+    state->timestamp_us = now_us;
+    ++state->count;
+    taskEXIT_CRITICAL_ISR(&state->lock);
+
+    if (state->callback) {
+        state->callback(state->context);
+    }
+}
+
+} // namespace kopter
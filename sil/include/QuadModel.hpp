@@ -0,0 +1,140 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+
+#include <glm/gtc/quaternion.hpp>
+
+namespace kopter {
+
+/**
+ * @brief Physical parameters of the simulated quadcopter.
+ *
+ * Defaults describe a small brushed X-frame that hovers at half throttle.
+ */
+struct QuadModelParams {
+    /// Total mass in kg.
+    float mass = 0.06f;
+
+    /// Lever arm of a motor around the roll and pitch axes in m.
+    float arm_length = 0.032f;
+
+    /// Diagonal of the inertia tensor in kg·m².
+    glm::vec3 inertia{3.0e-5f, 3.0e-5f, 5.5e-5f};
+
+    /// Thrust of one motor at full throttle in N. Thrust scales with the square of the throttle.
+    float max_thrust = 0.6f;
+
+    /// Reaction torque per Newton of thrust in N·m/N.
+    float yaw_torque_coeff = 0.01f;
+
+    /// First-order time constant of the motor response in s.
+    float motor_time_constant = 0.02f;
+
+    /// Linear drag coefficient in N·s/m.
+    float linear_drag = 0.05f;
+
+    /// Rotational drag coefficient in N·m·s/rad.
+    float angular_drag = 2.0e-6f;
+};
+
+/**
+ * @brief State of the simulated quadcopter.
+ *
+ * The world frame is Z-up, the body frame is X-forward, Y-left, Z-up.
+ */
+struct QuadState {
+    /// Position in the world frame in m.
+    glm::vec3 position;
+
+    /// Velocity in the world frame in m/s.
+    glm::vec3 velocity;
+
+    /// Rotation from the body frame to the world frame.
+    glm::quat attitude;
+
+    /// Angular velocity in the body frame in rad/s.
+    glm::vec3 angular_velocity;
+
+    /// Specific force (what an accelerometer measures) in the body frame in m/s².
+    glm::vec3 specific_force;
+
+    /// Current, lagged throttle of every motor in [0, 1].
+    std::array<float, 4> motor_throttles;
+};
+
+/**
+ * @brief Rigid-body model of an X-configuration quadcopter.
+ *
+ * Motor order and torque directions match `XMotorMixer`: a positive roll, pitch or yaw command
+ * produces a positive torque around the body X, Y or Z axis respectively.
+ *
+ * The model is deterministic and has no notion of wall-clock time; it advances only through `step()`.
+ */
+class QuadModel {
+public:
+    /// Standard gravity in m/s².
+    static constexpr float GRAVITY = 9.80665f;
+
+    /**
+     * @brief Ctor for a model resting at the origin.
+     *
+     * @param params Physical parameters.
+     */
+    explicit QuadModel(const QuadModelParams &params = {}) noexcept;
+
+    /**
+     * @brief Sets the commanded throttle of one motor.
+     *
+     * @param motor Motor index in [0, 3].
+     * @param throttle Throttle in [0, 1]. Values outside are clamped.
+     */
+    void set_throttle(size_t motor, float throttle) noexcept;
+
+    /**
+     * @brief Places the model at the given position and attitude with zero velocities.
+     */
+    void reset(const glm::vec3 &position, const glm::quat &attitude) noexcept;
+
+    /**
+     * @brief Adds an external torque in the body frame, applied until cleared.
+     *
+     * @param torque Torque in N·m.
+     */
+    void set_disturbance_torque(const glm::vec3 &torque) noexcept;
+
+    /**
+     * @brief Advances the simulation.
+     *
+     * @param dt Time step in seconds.
+     */
+    void step(float dt) noexcept;
+
+    /**
+     * @brief Returns the current state.
+     */
+    const QuadState &get_state() const noexcept;
+
+private:
+    QuadModelParams m_params;
+    QuadState m_state;
+    std::array<float, 4> m_commanded_throttles;
+    glm::vec3 m_disturbance_torque;
+};
+
+} // namespace kopter
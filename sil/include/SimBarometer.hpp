@@ -0,0 +1,79 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+#include "IBarometer.hpp"
+#include "QuadModel.hpp"
+
+#include <random>
+
+namespace kopter {
+
+/**
+ * @brief Simulated barometer sampling the altitude of a `QuadModel`.
+ *
+ * Converts the model altitude to pressure with the standard atmosphere and adds Gaussian pressure noise. Every
+ * `read_pressure()` stands for one conversion and can go through an IIR filter like the one of the BMP280, which
+ * adds its lag.
+ */
+class SimBarometer : public IBarometer {
+public:
+    /**
+     * @brief Ctor for a simulated barometer.
+     *
+     * @param model Model to sample. Must outlive the barometer.
+     * @param ground_altitude Altitude of the model origin above sea level in m.
+     * @param pressure_noise Standard deviation of the pressure noise in Pa.
+     * @param seed Seed of the noise generator.
+     * @param filter_coefficient Coefficient of the IIR filter, 1 for none; the BMP280 offers 2, 4, 8 and 16.
+     */
+    SimBarometer(const QuadModel &model,
+                 float ground_altitude = 0.0f,
+                 float pressure_noise = 1.5f,
+                 uint32_t seed = 2,
+                 uint32_t filter_coefficient = 1);
+
+    /**
+     * @brief Returns the `"[SimBarometer]"`.
+     */
+    const char *get_name() const noexcept override;
+
+    /**
+     * @brief Returns a constant temperature of 20 °C.
+     */
+    float read_temperature() override;
+
+    /**
+     * @brief Returns the noisy, filtered static pressure at the model altitude in Pa.
+     */
+    float read_pressure() override;
+
+    /**
+     * @brief Returns the altitude derived from `read_pressure()` in m.
+     */
+    float read_altitude() override;
+
+private:
+    const QuadModel &m_model;
+    float m_ground_altitude;
+    std::mt19937 m_rng;
+    std::normal_distribution<float> m_pressure_noise;
+    float m_filter_coefficient;
+    float m_filtered_pressure;
+};
+
+} // namespace kopter
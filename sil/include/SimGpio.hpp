@@ -0,0 +1,93 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#pragma once
+
+#include "driver/gpio.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace kopter {
+
+/**
+ * @brief Host GPIO matrix serving the `driver/gpio.h` shim.
+ *
+ * Records the configuration of every pin and the interrupt handlers added through the ISR service. `raise()`
+ * plays the role of an edge on a pin: it runs the handler synchronously on the calling thread, so a test
+ * controls exactly when an interrupt "fires" relative to the code under test.
+ */
+class SimGpio {
+public:
+    /**
+     * @brief Returns the GPIO instance used by the shim.
+     */
+    static SimGpio &get_instance();
+
+    /**
+     * @brief Applies a configuration to every pin in its bit mask.
+     *
+     * @return `ESP_ERR_INVALID_ARG` if the mask selects no pin or a pin out of range, `ESP_OK` otherwise.
+     */
+    esp_err_t configure(const gpio_config_t &config);
+
+    /**
+     * @brief Installs the ISR service.
+     *
+     * @return `ESP_ERR_INVALID_STATE` if the service is already installed, `ESP_OK` otherwise.
+     */
+    esp_err_t install_isr_service();
+
+    /**
+     * @brief Adds the interrupt handler of a pin, replacing any previous one.
+     *
+     * @return `ESP_ERR_INVALID_STATE` without the ISR service, `ESP_ERR_INVALID_ARG` for a pin out of range,
+     *         `ESP_OK` otherwise.
+     */
+    esp_err_t add_handler(gpio_num_t pin, gpio_isr_t handler, void *arg);
+
+    /**
+     * @brief Removes the interrupt handler of a pin.
+     */
+    esp_err_t remove_handler(gpio_num_t pin);
+
+    /**
+     * @brief Signals an edge on a pin.
+     *
+     * The handler runs if the pin is an input with an edge interrupt configured and a handler added.
+     *
+     * @return Whether a handler ran.
+     */
+    bool raise(gpio_num_t pin);
+
+private:
+    struct Pin {
+        gpio_config_t config{};
+        gpio_isr_t handler = nullptr;
+        void *arg = nullptr;
+    };
+
+    static constexpr size_t PIN_COUNT = GPIO_NUM_MAX;
+
+    SimGpio() = default;
+
+    std::array<Pin, PIN_COUNT> m_pins{};
+    bool m_isr_service_installed = false;
+};
+
+} // namespace kopter
@@ -0,0 +1,45 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace kopter {
+
+/**
+ * @brief Host counterpart of `HeapGuard`.
+ *
+ * Replaces the global `operator new` of the SIL runner and counts every allocation made while armed.
+ */
+struct SimHeapGuard {
+    /**
+     * @brief Starts counting allocations.
+     */
+    static void arm() noexcept;
+
+    /**
+     * @brief Stops counting allocations.
+     */
+    static void disarm() noexcept;
+
+    /**
+     * @brief Returns the number of allocations made while armed.
+     */
+    static uint64_t get_violations() noexcept;
+};
+
+} // namespace kopter
@@ -0,0 +1,124 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#pragma once
+
+#include "esp_err.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace kopter {
+
+/**
+ * @brief Host I2C bus serving the `driver/i2c.h` shim.
+ *
+ * Every attached device is a 256-byte register file behind an auto-incrementing register pointer, which is
+ * how the MPU6050 and BMP280 behave: the first byte of a write selects the register, further bytes are
+ * written from there on, and reads continue from the selected register. Transfers to an address with
+ * nothing attached fail as a NACK would.
+ *
+ * A device may also have a FIFO like the MPU6050's: reads of its data register pop bytes without moving the
+ * register pointer, and its big-endian count register pair reports the number of buffered bytes.
+ */
+class SimI2cBus {
+public:
+    using RegisterFile = std::array<uint8_t, 256>;
+
+    /**
+     * @brief Returns the bus instance used by the shim.
+     */
+    static SimI2cBus &get_instance();
+
+    /**
+     * @brief Attaches a device, or returns the one already attached at the address.
+     *
+     * @param address 7-bit I2C address of the device.
+     * @return The register file of the device, to be preset or inspected by the caller.
+     */
+    RegisterFile &attach(uint8_t address);
+
+    /**
+     * @brief Gives an attached device a FIFO.
+     *
+     * @param address 7-bit I2C address of the device.
+     * @param data_reg Register popping FIFO bytes when read.
+     * @param count_reg First of the two registers holding the FIFO byte count, high byte first.
+     */
+    void attach_fifo(uint8_t address, uint8_t data_reg, uint8_t count_reg);
+
+    /**
+     * @brief Appends bytes to the FIFO of a device; bytes that do not fit are dropped.
+     */
+    void push_fifo(uint8_t address, const uint8_t *data, size_t size);
+
+    /**
+     * @brief Selects a register and writes the remaining bytes from there on.
+     *
+     * @return `ESP_FAIL` if no device is attached at the address, `ESP_OK` otherwise.
+     */
+    esp_err_t write(uint8_t address, const uint8_t *data, size_t size);
+
+    /**
+     * @brief Reads bytes starting at the selected register.
+     *
+     * @return `ESP_FAIL` if no device is attached at the address, `ESP_OK` otherwise.
+     */
+    esp_err_t read(uint8_t address, uint8_t *data, size_t size);
+
+    /**
+     * @brief Writes and then reads back in one transfer, as a repeated start does.
+     *
+     * @return `ESP_FAIL` if no device is attached at the address, `ESP_OK` otherwise.
+     */
+    esp_err_t write_read(
+        uint8_t address, const uint8_t *write_data, size_t write_size, uint8_t *read_data, size_t read_size);
+
+    /**
+     * @brief Returns the number of transfers served since start.
+     */
+    uint64_t get_transfers() const noexcept;
+
+private:
+    static constexpr size_t FIFO_SIZE = 1024;
+
+    struct Device {
+        RegisterFile registers{};
+        uint8_t pointer = 0;
+        bool has_fifo = false;
+        uint8_t fifo_data_reg = 0;
+        uint8_t fifo_count_reg = 0;
+        std::array<uint8_t, FIFO_SIZE> fifo{};
+        size_t fifo_head = 0;
+        size_t fifo_size = 0;
+    };
+
+    static constexpr size_t MAX_ADDRESSES = 128;
+
+    static uint8_t read_register(Device &device);
+
+    SimI2cBus() = default;
+
+    Device *find(uint8_t address) noexcept;
+
+    std::array<std::unique_ptr<Device>, MAX_ADDRESSES> m_devices{};
+    uint64_t m_transfers = 0;
+};
+
+} // namespace kopter
@@ -0,0 +1,81 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+#include "IMU.hpp"
+#include "QuadModel.hpp"
+
+#include <random>
+
+namespace kopter {
+
+/**
+ * @brief Simulated IMU sampling a `QuadModel`.
+ *
+ * Produces data in the same units as `MPU6050`: angular velocity in °/s and acceleration in g,
+ * with additive Gaussian noise and a constant gyroscope bias. Noise is seeded, so runs are reproducible.
+ */
+class SimIMU : public IMU {
+public:
+    /**
+     * @brief Ctor for a simulated IMU.
+     *
+     * @param model Model to sample. Must outlive the IMU.
+     * @param gyro_noise Standard deviation of the gyroscope noise in °/s.
+     * @param accel_noise Standard deviation of the accelerometer noise in g.
+     * @param gyro_bias Constant gyroscope bias in °/s.
+     * @param seed Seed of the noise generator.
+     */
+    SimIMU(const QuadModel &model,
+           float gyro_noise = 0.05f,
+           float accel_noise = 0.01f,
+           const glm::vec3 &gyro_bias = glm::vec3(0.0f),
+           uint32_t seed = 1);
+
+    /**
+     * @brief Returns the `"[SimIMU]"`.
+     */
+    const char *get_name() const noexcept override;
+
+    /**
+     * @brief Samples the model.
+     *
+     * @return Angular velocity and specific force of the model in sensor units.
+     */
+    IMUData get_data() override;
+
+    /**
+     * @brief Sets the offset subtracted from the simulated gyroscope, e.g. an estimate of its bias.
+     */
+    void set_gyro_bias(const GyroBias &bias) noexcept override;
+
+    /**
+     * @brief Sets the affine correction applied to the simulated accelerometer.
+     */
+    void set_accel_correction(const AccelCorrection &correction) noexcept override;
+
+private:
+    const QuadModel &m_model;
+    glm::vec3 m_gyro_bias;
+    glm::vec3 m_gyro_correction;
+    AccelCorrection m_accel_correction;
+    std::mt19937 m_rng;
+    std::normal_distribution<float> m_gyro_noise;
+    std::normal_distribution<float> m_accel_noise;
+};
+
+} // namespace kopter
@@ -0,0 +1,65 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+#include "IMotor.hpp"
+#include "QuadModel.hpp"
+
+namespace kopter {
+
+/**
+ * @brief Simulated motor forwarding its throttle to one rotor of a `QuadModel`.
+ */
+class SimMotor : public IMotor {
+public:
+    /**
+     * @brief Ctor for a simulated motor.
+     *
+     * @param model Model to drive. Must outlive the motor.
+     * @param index Rotor index in `XMotorMixer` order.
+     */
+    SimMotor(QuadModel &model, size_t index) noexcept;
+
+    /**
+     * @brief Returns the `"[SimMotor]"`.
+     */
+    const char *get_name() const noexcept override;
+
+    /**
+     * @brief Allows the motor to spin.
+     */
+    void enable() override;
+
+    /**
+     * @brief Stops the motor and ignores further speed updates until enabled.
+     */
+    void disable() override;
+
+    /**
+     * @brief Sets the rotor throttle.
+     *
+     * @param speed Throttle in [0, 1].
+     */
+    void set_speed(float speed) override;
+
+private:
+    QuadModel &m_model;
+    size_t m_index;
+    bool m_enabled;
+};
+
+} // namespace kopter
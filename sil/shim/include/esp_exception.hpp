@@ -0,0 +1,42 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+/*
+ * Host shim of `idf::ESPException` from esp-idf-cxx.
+ */
+
+#include "esp_err.h"
+
+#include <exception>
+
+namespace idf {
+
+struct ESPException : public std::exception {
+    explicit ESPException(esp_err_t error) : error{error}
+    {
+    }
+
+    const char *what() const noexcept override
+    {
+        return esp_err_to_name(error);
+    }
+
+    const esp_err_t error;
+};
+
+} // namespace idf
@@ -0,0 +1,57 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+/*
+ * Host shim of the FreeRTOS task API. Tasks run as detached host threads, ignoring priority and core, and a task
+ * ends when its function returns. Delays return immediately: the SIL build runs in simulated time.
+ */
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SimTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task_fn,
+                                   const char *name,
+                                   uint32_t stack_size,
+                                   void *param,
+                                   UBaseType_t priority,
+                                   TaskHandle_t *created_task,
+                                   BaseType_t core_id);
+BaseType_t xTaskCreate(TaskFunction_t task_fn,
+                       const char *name,
+                       uint32_t stack_size,
+                       void *param,
+                       UBaseType_t priority,
+                       TaskHandle_t *created_task);
+void vTaskDelete(TaskHandle_t task);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define vTaskDelay(ticks) ((void)(ticks))
+#define vTaskDelayUntil(previous_wake, ticks) ((void)(previous_wake), (void)(ticks))
+#define xTaskGetTickCount() ((TickType_t)0)
@@ -0,0 +1,59 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#pragma once
+
+/*
+ * Host shim of the `pid_ctrl` component API, with the same positional/incremental algorithms.
+ */
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct pid_ctrl_block_t *pid_ctrl_block_handle_t;
+
+typedef enum {
+    PID_CAL_TYPE_INCREMENTAL,
+    PID_CAL_TYPE_POSITIONAL,
+} pid_calculate_type_t;
+
+typedef struct {
+    float kp;
+    float ki;
+    float kd;
+    float max_output;
+    float min_output;
+    float max_integral;
+    float min_integral;
+    pid_calculate_type_t cal_type;
+} pid_ctrl_parameter_t;
+
+typedef struct {
+    pid_ctrl_parameter_t init_param;
+} pid_ctrl_config_t;
+
+esp_err_t pid_new_control_block(const pid_ctrl_config_t *config, pid_ctrl_block_handle_t *ret_pid);
+esp_err_t pid_del_control_block(pid_ctrl_block_handle_t pid);
+esp_err_t pid_compute(pid_ctrl_block_handle_t pid, float input_error, float *ret_result);
+esp_err_t pid_update_parameters(pid_ctrl_block_handle_t pid, const pid_ctrl_parameter_t *params);
+esp_err_t pid_reset_ctrl_block(pid_ctrl_block_handle_t pid);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,228 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+/*
+ * Host implementation of the FreeRTOS shims on std::thread, std::mutex and std::condition_variable. Ticks are
+ * milliseconds, as `pdMS_TO_TICKS` defines them.
+ */
+
+namespace {
+
+/**
+ * @brief Counting wait used for task notifications and semaphores.
+ */
+struct Signal {
+    /**
+     * @brief Waits until the count is non-zero or the timeout expires and returns the count before taking.
+     */
+    uint32_t take(bool clear, TickType_t ticks_to_wait)
+    {
+        std::unique_lock lock(mutex);
+        const auto ready = [this] { return count != 0; };
+        if (ticks_to_wait == portMAX_DELAY) {
+            condition.wait(lock, ready);
+        }
+        else {
+            condition.wait_for(lock, std::chrono::milliseconds(ticks_to_wait), ready);
+        }
+        const uint32_t taken = count;
+        if (taken != 0) {
+            count = clear ? 0 : count - 1;
+        }
+        return taken;
+    }
+
+    /**
+     * @brief Increments the count up to `max_count` and wakes a waiter.
+     *
+     * Notifies under the lock: a woken `I2cBusScheduler::run` deletes its semaphore right away.
+     */
+    void give(uint32_t max_count)
+    {
+        std::lock_guard lock(mutex);
+        if (count < max_count) {
+            ++count;
+        }
+        condition.notify_one();
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    uint32_t count = 0;
+};
+
+} // namespace
+
+struct SimTask {
+    Signal notification;
+};
+
+struct SimQueue {
+    std::mutex mutex;
+    std::vector<uint8_t> items;
+    size_t item_size;
+    size_t length;
+    size_t head = 0;
+    size_t count = 0;
+};
+
+struct SimSemaphore {
+    Signal signal;
+    bool is_static;
+};
+
+namespace {
+// Tasks created through the shim point this at their handle; any other thread, e.g. the main one, gets its own.
+thread_local SimTask *t_created_task = nullptr;
+thread_local SimTask t_thread_task;
+} // namespace
+
+static_assert(sizeof(SimSemaphore) <= sizeof(StaticSemaphore_t) && alignof(SimSemaphore) <= alignof(StaticSemaphore_t));
+
+extern "C" {
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task_fn,
+                                   const char *,
+                                   uint32_t,
+                                   void *param,
+                                   UBaseType_t,
+                                   TaskHandle_t *created_task,
+                                   BaseType_t)
+{
+    auto *task = new SimTask;
+    if (created_task) {
+        *created_task = task;
+    }
+    std::thread([task, task_fn, param] {
+        t_created_task = task;
+        task_fn(param);
+        delete task;
+    }).detach();
+    return pdTRUE;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task_fn,
+                       const char *name,
+                       uint32_t stack_size,
+                       void *param,
+                       UBaseType_t priority,
+                       TaskHandle_t *created_task)
+{
+    return xTaskCreatePinnedToCore(task_fn, name, stack_size, param, priority, created_task, 0);
+}
+
+void vTaskDelete(TaskHandle_t)
+{
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return t_created_task ? t_created_task : &t_thread_task;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    task->notification.give(UINT32_MAX);
+    return pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    return xTaskGetCurrentTaskHandle()->notification.take(clear_on_exit == pdTRUE, ticks_to_wait);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    auto *queue = new SimQueue;
+    queue->items.resize(static_cast<size_t>(length) * item_size);
+    queue->item_size = item_size;
+    queue->length = length;
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t)
+{
+    std::lock_guard lock(queue->mutex);
+    if (queue->count == queue->length) {
+        return pdFALSE;
+    }
+    const size_t tail = (queue->head + queue->count) % queue->length;
+    std::memcpy(queue->items.data() + tail * queue->item_size, item, queue->item_size);
+    ++queue->count;
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *buffer, TickType_t)
+{
+    std::lock_guard lock(queue->mutex);
+    if (queue->count == 0) {
+        return pdFALSE;
+    }
+    std::memcpy(buffer, queue->items.data() + queue->head * queue->item_size, queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    --queue->count;
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    std::lock_guard lock(queue->mutex);
+    return static_cast<UBaseType_t>(queue->count);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *storage)
+{
+    return new (storage->storage) SimSemaphore{.signal = {}, .is_static = true};
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    if (semaphore->is_static) {
+        semaphore->~SimSemaphore();
+    }
+    else {
+        delete semaphore;
+    }
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    semaphore->signal.give(1);
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    return semaphore->signal.take(false, ticks_to_wait) != 0 ? pdTRUE : pdFALSE;
+}
+}
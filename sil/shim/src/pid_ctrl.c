@@ -0,0 +1,144 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "pid_ctrl.h"
+
+#include <stdlib.h>
+
+struct pid_ctrl_block_t {
+    float Kp;
+    float Ki;
+    float Kd;
+    float previous_err1;
+    float previous_err2;
+    float integral_err;
+    float last_output;
+    float max_output;
+    float min_output;
+    float max_integral;
+    float min_integral;
+    float (*calculate_func)(struct pid_ctrl_block_t *pid, float error);
+};
+
+static float clamp(float value, float min, float max)
+{
+    return value > max ? max : (value < min ? min : value);
+}
+
+static float pid_calc_positional(struct pid_ctrl_block_t *pid, float error)
+{
+    pid->integral_err = clamp(pid->integral_err + error, pid->min_integral, pid->max_integral);
+    float output = error * pid->Kp + (error - pid->previous_err1) * pid->Kd + pid->integral_err * pid->Ki;
+    pid->previous_err1 = error;
+
+    return clamp(output, pid->min_output, pid->max_output);
+}
+
+static float pid_calc_incremental(struct pid_ctrl_block_t *pid, float error)
+{
+    float output = (error - pid->previous_err1) * pid->Kp +
+                   (error - 2 * pid->previous_err1 + pid->previous_err2) * pid->Kd + error * pid->Ki +
+                   pid->last_output;
+    output = clamp(output, pid->min_output, pid->max_output);
+    pid->previous_err2 = pid->previous_err1;
+    pid->previous_err1 = error;
+    pid->last_output = output;
+
+    return output;
+}
+
+esp_err_t pid_new_control_block(const pid_ctrl_config_t *config, pid_ctrl_block_handle_t *ret_pid)
+{
+    if (!config || !ret_pid) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct pid_ctrl_block_t *pid = calloc(1, sizeof(struct pid_ctrl_block_t));
+    if (!pid) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = pid_update_parameters(pid, &config->init_param);
+    if (ret != ESP_OK) {
+        free(pid);
+        return ret;
+    }
+    *ret_pid = pid;
+
+    return ESP_OK;
+}
+
+esp_err_t pid_del_control_block(pid_ctrl_block_handle_t pid)
+{
+    if (!pid) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    free(pid);
+
+    return ESP_OK;
+}
+
+esp_err_t pid_compute(pid_ctrl_block_handle_t pid, float input_error, float *ret_result)
+{
+    if (!pid || !ret_result) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *ret_result = pid->calculate_func(pid, input_error);
+
+    return ESP_OK;
+}
+
+esp_err_t pid_update_parameters(pid_ctrl_block_handle_t pid, const pid_ctrl_parameter_t *params)
+{
+    if (!pid || !params) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pid->Kp = params->kp;
+    pid->Ki = params->ki;
+    pid->Kd = params->kd;
+    pid->max_output = params->max_output;
+    pid->min_output = params->min_output;
+    pid->max_integral = params->max_integral;
+    pid->min_integral = params->min_integral;
+
+    switch (params->cal_type) {
+    case PID_CAL_TYPE_INCREMENTAL:
+        pid->calculate_func = pid_calc_incremental;
+        break;
+    case PID_CAL_TYPE_POSITIONAL:
+        pid->calculate_func = pid_calc_positional;
+        break;
+    default:
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t pid_reset_ctrl_block(pid_ctrl_block_handle_t pid)
+{
+    if (!pid) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pid->integral_err = 0;
+    pid->previous_err1 = 0;
+    pid->previous_err2 = 0;
+    pid->last_output = 0;
+
+    return ESP_OK;
+}
@@ -0,0 +1,108 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "QuadModel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace kopter {
+
+namespace {
+constexpr float ROLL_SIGNS[] = {-1.0f, 1.0f, 1.0f, -1.0f};
+constexpr float PITCH_SIGNS[] = {1.0f, 1.0f, -1.0f, -1.0f};
+constexpr float YAW_SIGNS[] = {1.0f, -1.0f, 1.0f, -1.0f};
+constexpr float MIN_ANGLE = 1e-9f;
+const glm::vec3 UP{0.0f, 0.0f, 1.0f};
+} // namespace
+
+QuadModel::QuadModel(const QuadModelParams &params) noexcept
+    : m_params{params}, m_state{}, m_commanded_throttles{}, m_disturbance_torque{0.0f}
+{
+    reset(glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+}
+
+void QuadModel::set_throttle(size_t motor, float throttle) noexcept
+{
+    m_commanded_throttles[motor] = std::clamp(throttle, 0.0f, 1.0f);
+}
+
+void QuadModel::reset(const glm::vec3 &position, const glm::quat &attitude) noexcept
+{
+    m_state.position = position;
+    m_state.velocity = glm::vec3(0.0f);
+    m_state.attitude = glm::normalize(attitude);
+    m_state.angular_velocity = glm::vec3(0.0f);
+    m_state.specific_force = glm::conjugate(m_state.attitude) * (UP * GRAVITY);
+}
+
+void QuadModel::set_disturbance_torque(const glm::vec3 &torque) noexcept
+{
+    m_disturbance_torque = torque;
+}
+
+void QuadModel::step(float dt) noexcept
+{
+    const float motor_blend = dt / (m_params.motor_time_constant + dt);
+    float total_thrust = 0.0f;
+    glm::vec3 torque = m_disturbance_torque;
+
+    for (size_t i = 0; i != m_state.motor_throttles.size(); ++i) {
+        auto &throttle = m_state.motor_throttles[i];
+        throttle += (m_commanded_throttles[i] - throttle) * motor_blend;
+
+        const float thrust = m_params.max_thrust * throttle * throttle;
+        total_thrust += thrust;
+        torque.x += ROLL_SIGNS[i] * thrust * m_params.arm_length;
+        torque.y += PITCH_SIGNS[i] * thrust * m_params.arm_length;
+        torque.z += YAW_SIGNS[i] * thrust * m_params.yaw_torque_coeff;
+    }
+
+    // Rotational dynamics in the body frame: I·dω/dt = τ - ω × (I·ω) - drag·ω
+    auto &omega = m_state.angular_velocity;
+    torque -= glm::cross(omega, m_params.inertia * omega) + omega * m_params.angular_drag;
+    omega += torque / m_params.inertia * dt;
+
+    const float angle = glm::length(omega) * dt;
+    if (angle > MIN_ANGLE) {
+        m_state.attitude = glm::normalize(m_state.attitude * glm::angleAxis(angle, glm::normalize(omega)));
+    }
+
+    // Translational dynamics in the world frame.
+    const glm::vec3 thrust_world = m_state.attitude * (UP * total_thrust);
+    const glm::vec3 force = thrust_world - m_state.velocity * m_params.linear_drag;
+    glm::vec3 acceleration = force / m_params.mass - UP * GRAVITY;
+
+    m_state.velocity += acceleration * dt;
+    m_state.position += m_state.velocity * dt;
+
+    if (m_state.position.z <= 0.0f) {
+        m_state.position.z = 0.0f;
+        if (m_state.velocity.z < 0.0f) {
+            m_state.velocity = glm::vec3(0.0f);
+        }
+        acceleration = glm::vec3(0.0f);
+    }
+
+    m_state.specific_force = glm::conjugate(m_state.attitude) * (acceleration + UP * GRAVITY);
+}
+
+const QuadState &QuadModel::get_state() const noexcept
+{
+    return m_state;
+}
+
+} // namespace kopter
@@ -0,0 +1,69 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "pch.hpp"
+#include "SimBarometer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace kopter {
+
+namespace {
+constexpr float SEA_LEVEL_PRESSURE = 101325.0f;
+constexpr float ALTITUDE_SCALE = 44330.0f;
+constexpr float ALTITUDE_EXPONENT = 0.1903f;
+constexpr float TEMPERATURE = 20.0f;
+} // namespace
+
+SimBarometer::SimBarometer(
+    const QuadModel &model, float ground_altitude, float pressure_noise, uint32_t seed, uint32_t filter_coefficient)
+    : IBarometer(), m_model{model}, m_ground_altitude{ground_altitude}, m_rng{seed}, m_pressure_noise{0.0f,
+                                                                                                        pressure_noise},
+      m_filter_coefficient{static_cast<float>(std::max<uint32_t>(filter_coefficient, 1))}, m_filtered_pressure{0.0f}
+{
+}
+
+const char *SimBarometer::get_name() const noexcept
+{
+    return "[SimBarometer]";
+}
+
+float SimBarometer::read_temperature()
+{
+    return TEMPERATURE;
+}
+
+float SimBarometer::read_pressure()
+{
+    const float altitude = m_ground_altitude + m_model.get_state().position.z;
+    const float pressure = SEA_LEVEL_PRESSURE * std::pow(1.0f - altitude / ALTITUDE_SCALE, 1.0f / ALTITUDE_EXPONENT);
+    const float measured = pressure + m_pressure_noise(m_rng);
+
+    // As the BMP280, the filter starts at the first conversion.
+    if (m_filtered_pressure == 0.0f) {
+        m_filtered_pressure = measured;
+    }
+    m_filtered_pressure += (measured - m_filtered_pressure) / m_filter_coefficient;
+    return m_filtered_pressure;
+}
+
+float SimBarometer::read_altitude()
+{
+    return ALTITUDE_SCALE * (1.0f - std::pow(read_pressure() / SEA_LEVEL_PRESSURE, ALTITUDE_EXPONENT));
+}
+
+} // namespace kopter
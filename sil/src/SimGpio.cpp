@@ -0,0 +1,116 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "pch.hpp"
+#include "SimGpio.hpp"
+
+namespace kopter {
+
+SimGpio &SimGpio::get_instance()
+{
+    static SimGpio instance;
+    return instance;
+}
+
+esp_err_t SimGpio::configure(const gpio_config_t &config)
+{
+    if (config.pin_bit_mask == 0 || (config.pin_bit_mask >> PIN_COUNT) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (size_t pin = 0; pin < PIN_COUNT; ++pin) {
+        if (config.pin_bit_mask & (1ULL << pin)) {
+            m_pins[pin].config = config;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t SimGpio::install_isr_service()
+{
+    if (m_isr_service_installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    m_isr_service_installed = true;
+    return ESP_OK;
+}
+
+esp_err_t SimGpio::add_handler(gpio_num_t pin, gpio_isr_t handler, void *arg)
+{
+    if (!m_isr_service_installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (pin < 0 || pin >= static_cast<int>(PIN_COUNT)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    m_pins[pin].handler = handler;
+    m_pins[pin].arg = arg;
+    return ESP_OK;
+}
+
+esp_err_t SimGpio::remove_handler(gpio_num_t pin)
+{
+    if (pin < 0 || pin >= static_cast<int>(PIN_COUNT)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    m_pins[pin].handler = nullptr;
+    m_pins[pin].arg = nullptr;
+    return ESP_OK;
+}
+
+bool SimGpio::raise(gpio_num_t pin)
+{
+    if (pin < 0 || pin >= static_cast<int>(PIN_COUNT)) {
+        return false;
+    }
+
+    const Pin &state = m_pins[pin];
+    if (state.config.mode != GPIO_MODE_INPUT || state.config.intr_type == GPIO_INTR_DISABLE || !state.handler) {
+        return false;
+    }
+
+    state.handler(state.arg);
+    return true;
+}
+
+} // namespace kopter
+
+extern "C" {
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    return kopter::SimGpio::get_instance().configure(*config);
+}
+
+esp_err_t gpio_install_isr_service(int)
+{
+    return kopter::SimGpio::get_instance().install_isr_service();
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args)
+{
+    return kopter::SimGpio::get_instance().add_handler(gpio_num, isr_handler, args);
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num)
+{
+    return kopter::SimGpio::get_instance().remove_handler(gpio_num);
+}
+}
@@ -0,0 +1,56 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "pch.hpp"
+#include "SimHeapGuard.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace kopter {
+
+namespace {
+bool s_armed = false;
+uint64_t s_violations = 0;
+} // namespace
+
+void SimHeapGuard::arm() noexcept
+{
+    s_armed = true;
+}
+
+void SimHeapGuard::disarm() noexcept
+{
+    s_armed = false;
+}
+
+uint64_t SimHeapGuard::get_violations() noexcept
+{
+    return s_violations;
+}
+
+} // namespace kopter
+
+void *operator new(std::size_t size)
+{
+    if (kopter::s_armed) {
+        ++kopter::s_violations;
+    }
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
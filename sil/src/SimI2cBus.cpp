@@ -0,0 +1,167 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "pch.hpp"
+#include "SimI2cBus.hpp"
+
+#include "driver/i2c.h"
+
+#include <cassert>
+
+namespace kopter {
+
+SimI2cBus &SimI2cBus::get_instance()
+{
+    static SimI2cBus instance;
+    return instance;
+}
+
+SimI2cBus::RegisterFile &SimI2cBus::attach(uint8_t address)
+{
+    auto &device = m_devices.at(address);
+    if (!device) {
+        device = std::make_unique<Device>();
+    }
+    return device->registers;
+}
+
+void SimI2cBus::attach_fifo(uint8_t address, uint8_t data_reg, uint8_t count_reg)
+{
+    Device *device = find(address);
+    assert(device);
+    device->has_fifo = true;
+    device->fifo_data_reg = data_reg;
+    device->fifo_count_reg = count_reg;
+}
+
+void SimI2cBus::push_fifo(uint8_t address, const uint8_t *data, size_t size)
+{
+    Device *device = find(address);
+    assert(device && device->has_fifo);
+    for (size_t i = 0; i < size && device->fifo_size < FIFO_SIZE; ++i, ++device->fifo_size) {
+        device->fifo[(device->fifo_head + device->fifo_size) % FIFO_SIZE] = data[i];
+    }
+}
+
+esp_err_t SimI2cBus::write(uint8_t address, const uint8_t *data, size_t size)
+{
+    return write_read(address, data, size, nullptr, 0);
+}
+
+esp_err_t SimI2cBus::read(uint8_t address, uint8_t *data, size_t size)
+{
+    return write_read(address, nullptr, 0, data, size);
+}
+
+esp_err_t SimI2cBus::write_read(
+    uint8_t address, const uint8_t *write_data, size_t write_size, uint8_t *read_data, size_t read_size)
+{
+    Device *device = find(address);
+    if (!device) {
+        return ESP_FAIL;
+    }
+
+    ++m_transfers;
+    if (write_size > 0) {
+        device->pointer = write_data[0];
+        for (size_t i = 1; i < write_size; ++i) {
+            device->registers[device->pointer++] = write_data[i];
+        }
+    }
+    for (size_t i = 0; i < read_size; ++i) {
+        read_data[i] = read_register(*device);
+    }
+    return ESP_OK;
+}
+
+uint64_t SimI2cBus::get_transfers() const noexcept
+{
+    return m_transfers;
+}
+
+uint8_t SimI2cBus::read_register(Device &device)
+{
+    if (device.has_fifo && device.pointer == device.fifo_data_reg) {
+        if (device.fifo_size == 0) {
+            return 0;
+        }
+        const uint8_t value = device.fifo[device.fifo_head];
+        device.fifo_head = (device.fifo_head + 1) % FIFO_SIZE;
+        --device.fifo_size;
+        return value;
+    }
+    if (device.has_fifo && device.pointer == device.fifo_count_reg) {
+        device.registers[device.fifo_count_reg] = static_cast<uint8_t>(device.fifo_size >> 8);
+        device.registers[device.fifo_count_reg + 1] = static_cast<uint8_t>(device.fifo_size);
+    }
+    return device.registers[device.pointer++];
+}
+
+SimI2cBus::Device *SimI2cBus::find(uint8_t address) noexcept
+{
+    return address < MAX_ADDRESSES ? m_devices[address].get() : nullptr;
+}
+
+} // namespace kopter
+
+extern "C" {
+
+esp_err_t i2c_param_config(i2c_port_t, const i2c_config_t *)
+{
+    return ESP_OK;
+}
+
+esp_err_t i2c_driver_install(i2c_port_t, i2c_mode_t, size_t, size_t, int)
+{
+    return ESP_OK;
+}
+
+esp_err_t i2c_driver_delete(i2c_port_t)
+{
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_write_to_device(i2c_port_t,
+                                     uint8_t device_address,
+                                     const uint8_t *write_buffer,
+                                     size_t write_size,
+                                     TickType_t)
+{
+    return kopter::SimI2cBus::get_instance().write(device_address, write_buffer, write_size);
+}
+
+esp_err_t i2c_master_read_from_device(i2c_port_t,
+                                      uint8_t device_address,
+                                      uint8_t *read_buffer,
+                                      size_t read_size,
+                                      TickType_t)
+{
+    return kopter::SimI2cBus::get_instance().read(device_address, read_buffer, read_size);
+}
+
+esp_err_t i2c_master_write_read_device(i2c_port_t,
+                                       uint8_t device_address,
+                                       const uint8_t *write_buffer,
+                                       size_t write_size,
+                                       uint8_t *read_buffer,
+                                       size_t read_size,
+                                       TickType_t)
+{
+    return kopter::SimI2cBus::get_instance().write_read(
+        device_address, write_buffer, write_size, read_buffer, read_size);
+}
+}
@@ -0,0 +1,63 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "pch.hpp"
+#include "SimIMU.hpp"
+
+namespace kopter {
+
+SimIMU::SimIMU(
+    const QuadModel &model, float gyro_noise, float accel_noise, const glm::vec3 &gyro_bias, uint32_t seed)
+    : IMU(), m_model{model}, m_gyro_bias{gyro_bias}, m_gyro_correction{0.0f}, m_accel_correction{}, m_rng{seed},
+      m_gyro_noise{0.0f, gyro_noise}, m_accel_noise{0.0f, accel_noise}
+{
+}
+
+const char *SimIMU::get_name() const noexcept
+{
+    return "[SimIMU]";
+}
+
+IMUData SimIMU::get_data()
+{
+    const auto &state = m_model.get_state();
+    const glm::vec3 gyro = glm::degrees(state.angular_velocity) + m_gyro_bias - m_gyro_correction;
+    const glm::vec3 force = state.specific_force / QuadModel::GRAVITY;
+    glm::vec3 accel;
+    for (int r = 0; r != 3; ++r) {
+        const float(&row)[3] = m_accel_correction.matrix[r];
+        accel[r] = row[0] * force.x + row[1] * force.y + row[2] * force.z + m_accel_correction.offset[r];
+    }
+
+    return {gyro.x + m_gyro_noise(m_rng),
+            gyro.y + m_gyro_noise(m_rng),
+            gyro.z + m_gyro_noise(m_rng),
+            accel.x + m_accel_noise(m_rng),
+            accel.y + m_accel_noise(m_rng),
+            accel.z + m_accel_noise(m_rng)};
+}
+
+void SimIMU::set_gyro_bias(const GyroBias &bias) noexcept
+{
+    m_gyro_correction = glm::vec3(bias.gx, bias.gy, bias.gz);
+}
+
+void SimIMU::set_accel_correction(const AccelCorrection &correction) noexcept
+{
+    m_accel_correction = correction;
+}
+
+} // namespace kopter
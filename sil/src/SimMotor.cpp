@@ -0,0 +1,50 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "pch.hpp"
+#include "SimMotor.hpp"
+
+namespace kopter {
+
+SimMotor::SimMotor(QuadModel &model, size_t index) noexcept
+    : IMotor(), m_model{model}, m_index{index}, m_enabled{true}
+{
+}
+
+const char *SimMotor::get_name() const noexcept
+{
+    return "[SimMotor]";
+}
+
+void SimMotor::enable()
+{
+    m_enabled = true;
+}
+
+void SimMotor::disable()
+{
+    m_enabled = false;
+    m_model.set_throttle(m_index, 0.0f);
+}
+
+void SimMotor::set_speed(float speed)
+{
+    if (m_enabled) {
+        m_model.set_throttle(m_index, speed);
+    }
+}
+
+} // namespace kopter
@@ -0,0 +1,777 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "pch.hpp"
+
+#include "AccelCalibration.hpp"
+#include "AltitudeReference.hpp"
+#include "BMP280.hpp"
+#include "GyroCalibration.hpp"
+#include "I2cBusScheduler.hpp"
+#include "I2cDeviceHolder.hpp"
+#include "MPU6050.hpp"
+#include "SimGpio.hpp"
+#include "SimHeapGuard.hpp"
+#include "SimI2cBus.hpp"
+
+#include "esp_timer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+using namespace kopter;
+
+namespace {
+constexpr uint8_t MPU6050_ADDRESS = 0x68;
+constexpr uint8_t BMP280_ADDRESS = 0x76;
+constexpr uint8_t HOUSEKEEPING_ADDRESS = 0x3C;
+constexpr uint64_t DEFAULT_ITERATIONS = 1000000;
+constexpr size_t FIFO_BATCH = 4;
+constexpr uint64_t SCHEDULER_ITERATION_DIVIDER = 100;
+constexpr gpio_num_t MPU6050_INT_PIN = static_cast<gpio_num_t>(4);
+constexpr const char *TAG = "[I2C bench]";
+
+// MPU6050 frame at 0x3B: level and at rest (az = +1 g at ±2 g), 25 °C, small gyroscope offsets.
+constexpr uint8_t MPU6050_FRAME_REG = 0x3B;
+constexpr std::array<uint8_t, 14> MPU6050_FRAME{
+    0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0xF0, 0x9C, 0x00, 0x83, 0xFF, 0x7D, 0x00, 0x00};
+constexpr uint8_t MPU6050_SMPLRT_DIV_REG = 0x19;
+constexpr uint8_t MPU6050_FIFO_COUNT_REG = 0x72;
+constexpr uint8_t MPU6050_FIFO_DATA_REG = 0x74;
+
+// BMP280 calibration at 0x88 and raw readings at 0xF7 from the datasheet example (section 8.2):
+// adc_P = 415148 and adc_T = 519888, i.e. 25.08 °C and ~100653 Pa.
+constexpr uint8_t BMP280_CALIB_REG = 0x88;
+constexpr std::array<uint8_t, 24> BMP280_CALIB{0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC, 0x7D, 0x8E,
+                                               0x43, 0xD6, 0xD0, 0x0B, 0x27, 0x0B, 0x8C, 0x00,
+                                               0xF9, 0xFF, 0x8C, 0x3C, 0xF8, 0xC6, 0x70, 0x17};
+constexpr uint8_t BMP280_DATA_REG = 0xF7;
+constexpr std::array<uint8_t, 6> BMP280_DATA{0x65, 0x5A, 0xC0, 0x7E, 0xED, 0x00};
+
+template <size_t N> void preset(SimI2cBus::RegisterFile &registers, uint8_t reg, const std::array<uint8_t, N> &bytes)
+{
+    std::copy(bytes.begin(), bytes.end(), registers.begin() + reg);
+}
+
+/**
+ * @brief Calls `read` `iterations` times with `SimHeapGuard` armed and reports time and allocations per call.
+ *
+ * @return true if no call allocated.
+ */
+template <typename Read> bool measure(const char *name, uint64_t iterations, Read &&read)
+{
+    const uint64_t allocations_before = SimHeapGuard::get_violations();
+    const uint64_t transfers_before = SimI2cBus::get_instance().get_transfers();
+    const auto start = std::chrono::steady_clock::now();
+    SimHeapGuard::arm();
+    for (uint64_t i = 0; i != iterations; ++i) {
+        read();
+    }
+    SimHeapGuard::disarm();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    const uint64_t allocations = SimHeapGuard::get_violations() - allocations_before;
+    const uint64_t transfers = SimI2cBus::get_instance().get_transfers() - transfers_before;
+
+    ESP_LOGI(TAG,
+             "%-30s %6.1f ns/call, %.1f transfers/call, %llu allocations",
+             name,
+             elapsed.count() / iterations,
+             static_cast<double>(transfers) / iterations,
+             static_cast<unsigned long long>(allocations));
+    return allocations == 0;
+}
+
+/**
+ * @brief Maps a frame the way `MPU6050Mapper` did before it precomputed its scales: a switch and a division per
+ * value. Kept as the baseline of the mapper benchmark.
+ *
+ * The baseline applies no calibration, while the mapper fuses in the accelerometer correction and subtracts the
+ * gyroscope bias, so it does more work per frame. On an x86-64 host with an FPU the two land within run-to-run
+ * noise of each other. Whether one multiply instead of a divide per value pays off on the ESP32 is not measured
+ * here.
+ */
+IMUData map_by_division(const MPU6050RawFrame &raw, AccelSensitivityMode accel_mode, GyroSensitivityMode gyro_mode)
+{
+    auto accel = [accel_mode](int16_t value) {
+        switch (accel_mode) {
+        case AccelSensitivityMode::A4G:
+            return value / 8192.0f;
+        case AccelSensitivityMode::A8G:
+            return value / 4096.0f;
+        case AccelSensitivityMode::A16G:
+            return value / 2048.0f;
+        default:
+            return value / 16384.0f;
+        }
+    };
+    auto gyro = [gyro_mode](int16_t value) {
+        switch (gyro_mode) {
+        case GyroSensitivityMode::DPS_500:
+            return value / 65.5f;
+        case GyroSensitivityMode::DPS_1000:
+            return value / 32.8f;
+        case GyroSensitivityMode::DPS_2000:
+            return value / 16.4f;
+        default:
+            return value / 131.0f;
+        }
+    };
+    return {.gx = gyro(raw.gx),
+            .gy = gyro(raw.gy),
+            .gz = gyro(raw.gz),
+            .ax = accel(raw.ax),
+            .ay = accel(raw.ay),
+            .az = accel(raw.az),
+            .temperature = raw.temperature / 340.0f + 36.53f};
+}
+
+/**
+ * @brief Loads a frame with a distinct value in every field into the register map at 0x3B and checks that one
+ * `get_data` call reads it in a single transfer and decodes each big-endian field into its own axis, at the default
+ * ±2 g / ±250 °/s.
+ */
+bool check_imu_frame(MPU6050 &imu, SimI2cBus::RegisterFile &registers)
+{
+    // ax 0.5 g, ay -0.5 g, az 1 g, -3940 LSB (24.94 °C), gx 1 °/s, gy -1 °/s, gz 2 °/s.
+    constexpr std::array<uint8_t, 14> frame{
+        0x20, 0x00, 0xE0, 0x00, 0x40, 0x00, 0xF0, 0x9C, 0x00, 0x83, 0xFF, 0x7D, 0x01, 0x06};
+    preset(registers, MPU6050_FRAME_REG, frame);
+    const uint64_t transfers_before = SimI2cBus::get_instance().get_transfers();
+    const IMUData data = imu.get_data();
+    const uint64_t transfers = SimI2cBus::get_instance().get_transfers() - transfers_before;
+    preset(registers, MPU6050_FRAME_REG, MPU6050_FRAME);
+
+    const bool ok = transfers == 1 && data.ax == 0.5f && data.ay == -0.5f && data.az == 1.0f && data.gx == 1.0f &&
+                    data.gy == -1.0f && data.gz == 2.0f && std::abs(data.temperature - 24.94f) < 0.01f;
+    ESP_LOGI(TAG,
+             "MPU6050 frame: a=(%.2f, %.2f, %.2f) g, g=(%.2f, %.2f, %.2f) deg/s, %.2f C in %llu transfer(s), %s",
+             data.ax,
+             data.ay,
+             data.az,
+             data.gx,
+             data.gy,
+             data.gz,
+             data.temperature,
+             static_cast<unsigned long long>(transfers),
+             ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+/**
+ * @brief Completion log of `check_bus_scheduler`.
+ */
+struct SchedulerTrace {
+    std::atomic<bool> holding{false};
+    std::atomic<bool> released{false};
+    std::atomic<size_t> completed{0};
+    std::array<std::atomic<I2cPriority>, I2C_PRIORITY_COUNT> order{};
+};
+
+/**
+ * @brief Runs `I2cBusScheduler` on a host thread and checks that `submit` returns before the transfer, that queued
+ * transactions complete IMU first, then barometer, then housekeeping, whatever their submission order, and that
+ * `run` returns the register contents. Then measures the round trip of a blocking IMU frame read through the bus
+ * task.
+ *
+ * @return true if the checks passed and `run` did not allocate.
+ */
+bool check_bus_scheduler(uint64_t iterations)
+{
+    SimI2cBus::get_instance().attach(HOUSEKEEPING_ADDRESS);
+    I2cDevice imu_device(MPU6050_ADDRESS, I2C_NUM_0, I2cPriority::IMU, nullptr);
+    I2cDevice barometer_device(BMP280_ADDRESS, I2C_NUM_0, I2cPriority::BAROMETER, nullptr);
+    I2cDevice housekeeping_device(HOUSEKEEPING_ADDRESS, I2C_NUM_0, I2cPriority::HOUSEKEEPING, nullptr);
+    // The bus task never exits, as on the target, so the scheduler is never destroyed.
+    auto *scheduler = new I2cBusScheduler();
+
+    // Hold the bus task in the callback of a first transaction, queue one transaction per priority in reverse
+    // order, then release it.
+    SchedulerTrace trace;
+    uint8_t reg = 0;
+    std::array<uint8_t, 1> hold_data;
+    I2cTransaction hold{.device = &housekeeping_device,
+                        .write_data = {&reg, 1},
+                        .read_data = hold_data,
+                        .on_complete = [](I2cTransaction &, void *context) {
+                            auto &trace = *static_cast<SchedulerTrace *>(context);
+                            trace.holding = true;
+                            while (!trace.released) {
+                                std::this_thread::yield();
+                            }
+                        },
+                        .context = &trace};
+    scheduler->submit(hold);
+    while (!trace.holding) {
+        std::this_thread::yield();
+    }
+
+    auto record = [](I2cTransaction &transaction, void *context) {
+        auto &trace = *static_cast<SchedulerTrace *>(context);
+        trace.order[trace.completed++] = transaction.device->get_priority();
+    };
+    std::array<std::array<uint8_t, 1>, I2C_PRIORITY_COUNT> data;
+    std::array<I2cTransaction, I2C_PRIORITY_COUNT> queued{
+        I2cTransaction{.device = &housekeeping_device, .write_data = {&reg, 1}, .read_data = data[0]},
+        I2cTransaction{.device = &barometer_device, .write_data = {&reg, 1}, .read_data = data[1]},
+        I2cTransaction{.device = &imu_device, .write_data = {&reg, 1}, .read_data = data[2]}};
+    for (auto &transaction : queued) {
+        transaction.on_complete = record;
+        transaction.context = &trace;
+        scheduler->submit(transaction);
+    }
+    const bool asynchronous = trace.completed == 0;
+    trace.released = true;
+
+    // Queued behind the housekeeping transaction above, so it returns once all of them are done.
+    std::array<uint8_t, MPU6050_FRAME.size()> frame{};
+    I2cTransaction read{.device = &housekeeping_device, .write_data = {&reg, 1}, .read_data = frame};
+    scheduler->run(read);
+    const bool ordered = trace.completed == I2C_PRIORITY_COUNT && trace.order[0] == I2cPriority::IMU &&
+                         trace.order[1] == I2cPriority::BAROMETER && trace.order[2] == I2cPriority::HOUSEKEEPING;
+
+    const uint8_t frame_reg = MPU6050_FRAME_REG;
+    I2cTransaction frame_read{.device = &imu_device, .write_data = {&frame_reg, 1}, .read_data = frame};
+    scheduler->run(frame_read);
+    const bool read_back = frame_read.result == ESP_OK && frame == MPU6050_FRAME;
+
+    const I2cQueueStats imu_stats = scheduler->get_stats(I2cPriority::IMU);
+    const bool ok = asynchronous && ordered && read_back;
+    ESP_LOGI(TAG,
+             "I2cBusScheduler: submit %s, completion order %u %u %u, run %s, %lu IMU transactions, %s",
+             asynchronous ? "returned before the transfer" : "BLOCKED",
+             static_cast<unsigned>(trace.order[0].load()),
+             static_cast<unsigned>(trace.order[1].load()),
+             static_cast<unsigned>(trace.order[2].load()),
+             read_back ? "read the frame" : "read WRONG DATA",
+             static_cast<unsigned long>(imu_stats.completed),
+             ok ? "ok" : "FAILED");
+
+    const bool allocation_free =
+        measure("I2cBusScheduler::run (frame)", std::max<uint64_t>(1, iterations / SCHEDULER_ITERATION_DIVIDER), [&] {
+            scheduler->run(frame_read);
+        });
+    return ok && allocation_free;
+}
+
+/**
+ * @brief Checks the compensated BMP280 burst against the datasheet example: 25.08 °C and 100653.27 Pa.
+ */
+bool check_barometer(BMP280 &barometer)
+{
+    const float temperature = barometer.read_temperature();
+    const float pressure = barometer.read_pressure();
+    const bool ok = std::abs(temperature - 25.08f) < 0.01f && std::abs(pressure - 100653.27f) < 1.0f;
+
+    ESP_LOGI(TAG, "BMP280: %.2f C, %.2f Pa, %s", temperature, pressure, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+/**
+ * @brief Checks that `BMP280` serves reads from its cache until the next conversion is due, without bus traffic,
+ * and reports the following conversion as a new sample.
+ */
+bool check_barometer_cache(SimI2cBus::RegisterFile &registers)
+{
+    auto &bus = SimI2cBus::get_instance();
+    BMP280 barometer(BMP280_ADDRESS);
+    const float first = barometer.read_pressure();
+    const bool first_new = barometer.has_new_sample();
+
+    // The next conversion reads adc_P one LSB lower, i.e. a slightly higher pressure.
+    std::array<uint8_t, 6> next = BMP280_DATA;
+    next[2] = 0xB0;
+    preset(registers, BMP280_DATA_REG, next);
+    const uint64_t transfers_before = bus.get_transfers();
+    const bool cached = barometer.read_pressure() == first && !barometer.has_new_sample() &&
+                        barometer.read_altitude() == barometer.read_altitude() &&
+                        bus.get_transfers() == transfers_before;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    const float fresh = barometer.read_pressure();
+    const bool updated = barometer.has_new_sample() && fresh > first && bus.get_transfers() == transfers_before + 1;
+    preset(registers, BMP280_DATA_REG, BMP280_DATA);
+
+    const bool ok = first_new && cached && updated;
+    ESP_LOGI(TAG,
+             "BMP280 cache: %.2f Pa cached without transfers, %.2f Pa after one conversion, %s",
+             first,
+             fresh,
+             ok ? "ok" : "FAILED");
+    return ok;
+}
+
+/**
+ * @brief Checks that a BMP280 read in normal mode before its first conversion, while the registers still hold the
+ * skipped reading 0x80000, is not taken as a sample, and that the conversion after it is.
+ */
+bool check_barometer_cold_start(SimI2cBus::RegisterFile &registers)
+{
+    constexpr std::array<uint8_t, 6> SKIPPED_DATA{0x80, 0x00, 0x00, 0x80, 0x00, 0x00};
+    preset(registers, BMP280_DATA_REG, SKIPPED_DATA);
+    BMP280 barometer(BMP280_ADDRESS);
+    AltitudeReference reference;
+    const float skipped = barometer.read_pressure();
+    const bool skipped_new = barometer.has_new_sample();
+
+    preset(registers, BMP280_DATA_REG, BMP280_DATA);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    const float first = barometer.read_pressure();
+    const bool first_new = barometer.has_new_sample();
+    const float altitude = reference.update(first).value_or(NAN);
+
+    const bool ok = !skipped_new && skipped == 0.0f && first_new && std::abs(first - 100653.27f) < 1.0f &&
+                    std::abs(reference.get_ground_elevation() - 56.0f) < 1.0f && std::abs(altitude) < 0.01f;
+    ESP_LOGI(TAG,
+             "BMP280 cold start: skipped reading %s, first conversion %.2f Pa, elevation %.1f m, %s",
+             skipped_new ? "TAKEN" : "ignored",
+             first,
+             reference.get_ground_elevation(),
+             ok ? "ok" : "FAILED");
+    return ok;
+}
+
+/**
+ * @brief Checks that `BMP280Config` reaches CTRL_MEAS and CONFIG, and that forced mode starts a conversion on a read
+ * and fetches it, starting the next one, once its longest measurement time has passed. Logs the timing of each
+ * profile.
+ */
+bool check_barometer_profiles(SimI2cBus::RegisterFile &registers)
+{
+    constexpr uint8_t CTRL_MEAS_REG = 0xF4;
+    constexpr uint8_t CONFIG_REG = 0xF5;
+
+    BMP280 barometer(BMP280_ADDRESS);
+    bool ok = registers[CTRL_MEAS_REG] == 0x2F && registers[CONFIG_REG] == 0x28;
+
+    const BMP280Config forced_config = BMP280Config::from_profile(BMP280Profile::ULTRA_LOW_LATENCY, BMP280Mode::FORCED);
+    barometer.set_config(forced_config);
+    ok &= registers[CTRL_MEAS_REG] == 0x29 && registers[CONFIG_REG] == 0x00;
+    registers[CTRL_MEAS_REG] = 0x28; // the sensor sleeps after a forced conversion
+    const float first = barometer.read_pressure();
+    ok &= std::abs(first - 100653.27f) < 1.0f && barometer.has_new_sample() && registers[CTRL_MEAS_REG] == 0x29;
+    registers[CTRL_MEAS_REG] = 0x28;
+    barometer.read_pressure();
+    ok &= registers[CTRL_MEAS_REG] == 0x28 && !barometer.has_new_sample();
+    std::this_thread::sleep_for(std::chrono::microseconds(forced_config.get_max_measurement_time_us()));
+    const float pressure = barometer.read_pressure();
+    ok &= std::abs(pressure - 100653.27f) < 1.0f && barometer.has_new_sample() && registers[CTRL_MEAS_REG] == 0x29;
+
+    for (const auto &[profile, name] : {std::pair{BMP280Profile::LOW_POWER, "low power"},
+                                        std::pair{BMP280Profile::STANDARD, "standard"},
+                                        std::pair{BMP280Profile::HIGH_RESOLUTION, "high resolution"},
+                                        std::pair{BMP280Profile::ULTRA_LOW_LATENCY, "ultra low latency"}}) {
+        const BMP280Config config = BMP280Config::from_profile(profile);
+        ESP_LOGI(TAG,
+                 "BMP280 %-17s: measurement %5.2f ms (max %5.2f ms), conversion every %7.2f ms",
+                 name,
+                 config.get_measurement_time_us() / 1e3,
+                 config.get_max_measurement_time_us() / 1e3,
+                 config.get_conversion_period_us() / 1e3);
+    }
+    ESP_LOGI(TAG, "BMP280 profiles: registers and forced conversion %s", ok ? "ok" : "FAILED");
+    return ok;
+}
+
+/**
+ * @brief Starts a BMP280 in forced mode and checks that the first reads zero the altitude reference at the ground.
+ *
+ * A first read that returned the empty cache of 0 Pa would zero the reference some 44 km up, so the first relative
+ * altitude would still be 0 m but the next conversion would land 44 km below it.
+ */
+bool check_forced_first_altitude()
+{
+    const BMP280Config config = BMP280Config::from_profile(BMP280Profile::ULTRA_LOW_LATENCY, BMP280Mode::FORCED);
+    BMP280 barometer(BMP280_ADDRESS, config);
+    AltitudeReference reference;
+
+    const float pressure = barometer.read_pressure();
+    const float first = reference.update(pressure).value_or(NAN);
+    const float elevation = reference.get_ground_elevation();
+    std::this_thread::sleep_for(std::chrono::microseconds(config.get_max_measurement_time_us()));
+    const float next = reference.update(barometer.read_pressure()).value_or(NAN);
+
+    const bool ok = std::abs(pressure - 100653.27f) < 1.0f && std::abs(first) < 0.01f &&
+                    std::abs(elevation - 56.0f) < 1.0f && barometer.has_new_sample() && std::abs(next) < 0.01f;
+    ESP_LOGI(TAG,
+             "BMP280 forced start: first %.0f Pa, relative altitude %.3f m then %.3f m, elevation %.1f m, %s",
+             pressure,
+             first,
+             next,
+             elevation,
+             ok ? "ok" : "FAILED");
+    return ok;
+}
+
+/**
+ * @brief The altitude formula `BMP280Mapper` evaluated before its table, kept as the reference and baseline.
+ */
+float map_altitude_by_pow(float pressure)
+{
+    return 44330.0f * (1.0f - std::pow(pressure / 101325.0f, 0.1903f));
+}
+
+/**
+ * @brief Sweeps the flight envelope of `BMP280Mapper::map_altitude` and a margin beyond it in 0.1 Pa steps against
+ * the formula in double precision. The error must stay within the documented 2 cm.
+ */
+bool check_altitude(BMP280Mapper &mapper)
+{
+    double max_error = 0.0;
+    float worst = 0.0f;
+    for (int decipascal = 450000; decipascal <= 1150000; ++decipascal) {
+        const float pressure = decipascal / 10.0f;
+        const double exact = 44330.0 * (1.0 - std::pow(pressure / 101325.0, 0.1903));
+        const double error = std::abs(mapper.map_altitude(pressure) - exact);
+        if (error > max_error) {
+            max_error = error;
+            worst = pressure;
+        }
+    }
+
+    const bool ok = max_error < 0.02;
+    ESP_LOGI(TAG,
+             "Altitude: max error %.1f mm at %.1f Pa over 45-115 kPa, %s",
+             max_error * 1e3,
+             worst,
+             ok ? "ok" : "FAILED");
+    return ok;
+}
+
+/**
+ * @brief Checks `AltitudeReference` on a simulated field at 500 m: the zero follows the ground pressure while
+ * disarmed, is frozen on arming, and a climb of 10 m reads as 10 m. Failed reads (NaN, 0 Pa and pressures outside
+ * 300..1100 hPa) are rejected and leave the zero alone, in the air and on the ground. A QNH of 1000 hPa lowers the
+ * altitude above sea level by about 111 m and leaves the relative altitude alone.
+ */
+bool check_altitude_reference()
+{
+    auto pressure_at = [](float altitude, float qnh_pa) {
+        return qnh_pa * std::pow(1.0f - altitude / 44330.0f, 1.0f / 0.1903f);
+    };
+    AltitudeReference reference(8);
+    const std::array<float, 5> failed_reads{std::nanf(""), 0.0f, -1.0f, 29999.0f, 110001.0f};
+    bool rejected = true;
+    for (const float pressure : failed_reads) {
+        rejected &= !reference.update(pressure);
+    }
+
+    // The weather drifts by 0.5 m on the ground; the last block before arming wins.
+    for (int i = 0; i != 16; ++i) {
+        const float noise = i % 2 == 0 ? 0.1f : -0.1f;
+        reference.update(pressure_at(500.0f + (i < 8 ? 0.0f : 0.5f) + noise, 101325.0f));
+        rejected &= !reference.update(failed_reads[i % failed_reads.size()]);
+    }
+    reference.set_armed(true);
+    const float ground = reference.update(pressure_at(500.5f, 101325.0f)).value_or(NAN);
+    const float climb = reference.update(pressure_at(510.5f, 101325.0f)).value_or(NAN);
+    for (const float pressure : failed_reads) {
+        rejected &= !reference.update(pressure);
+    }
+    const float elevation = reference.get_ground_elevation();
+
+    reference.set_qnh(100000.0f);
+    const float relative = reference.update(pressure_at(510.5f, 101325.0f)).value_or(NAN);
+    const float amsl_shift = reference.get_altitude_amsl() - (510.5f + elevation - 500.5f);
+
+    const bool ok = rejected && std::abs(ground) < 0.02f && std::abs(climb - 10.0f) < 0.05f &&
+                    std::abs(elevation - 500.5f) < 0.05f && std::abs(relative - climb) < 1e-3f &&
+                    std::abs(amsl_shift + 110.9f) < 1.0f;
+    ESP_LOGI(TAG,
+             "Altitude reference: ground %.3f m, climb %.3f m, elevation %.2f m, QNH 1000 hPa shifts %.1f m, "
+             "failed reads %s, %s",
+             ground,
+             climb,
+             elevation,
+             amsl_shift,
+             rejected ? "rejected" : "ACCEPTED",
+             ok ? "ok" : "FAILED");
+    return ok;
+}
+
+/**
+ * @brief Configures ±8 g / ±1000 °/s and checks the register burst and the rescaled frame (16384 LSB is 4 g).
+ */
+bool check_config(SimI2cBus::RegisterFile &registers)
+{
+    MPU6050 imu(MPU6050_ADDRESS,
+                {.accel_range = AccelSensitivityMode::A8G,
+                 .gyro_range = GyroSensitivityMode::DPS_1000,
+                 .dlpf = DlpfBandwidth::HZ_42,
+                 .sample_rate_divider = 4});
+    const IMUData data = imu.get_data();
+
+    const bool ok = registers[MPU6050_SMPLRT_DIV_REG] == 4 && registers[MPU6050_SMPLRT_DIV_REG + 1] == 3 &&
+                    registers[MPU6050_SMPLRT_DIV_REG + 2] == 0x10 && registers[MPU6050_SMPLRT_DIV_REG + 3] == 0x10 &&
+                    data.az == 4.0f && imu.get_config().get_sample_rate_hz() == 200;
+    ESP_LOGI(TAG,
+             "Config: ±8 g / ±1000 deg/s, raw 1 g frame reads az=%.3f g, gx=%.3f deg/s, %s",
+             data.az,
+             data.gx,
+             ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+/**
+ * @brief Calibrates the gyroscope offsets of the frame cold, then warm from the result, and checks both remove them.
+ * The calibration paces its reads as on the target; the delays of the FreeRTOS shim return at once.
+ */
+bool check_gyro_calibration(MPU6050 &imu)
+{
+    GyroCalibration calibration;
+    const GyroCalibrationResult cold = calibration.run(imu, std::nullopt);
+    const IMUData cold_data = imu.get_data();
+    const GyroCalibrationResult warm = calibration.run(imu, cold.bias);
+    const IMUData warm_data = imu.get_data();
+    imu.set_gyro_bias({});
+
+    const bool ok = cold.source == GyroCalibrationSource::CALIBRATED && cold_data.gx == 0.0f &&
+                    cold_data.gy == 0.0f && warm.source == GyroCalibrationSource::WARM_START &&
+                    warm_data.gx == 0.0f && warm_data.gy == 0.0f && warm.sample_count < cold.sample_count;
+    ESP_LOGI(TAG,
+             "Gyro calibration: %lu samples cold, %lu warm, corrected g=(%.3f, %.3f) deg/s, %s",
+             static_cast<unsigned long>(cold.sample_count),
+             static_cast<unsigned long>(warm.sample_count),
+             warm_data.gx,
+             warm_data.gy,
+             ok ? "ok" : "FAILED");
+    return ok;
+}
+
+/**
+ * @brief Solves the six-position calibration for synthetic readings of a known faulty accelerometer.
+ *
+ * The accelerometer reads `E * g + b` with scale errors of up to 2 %, misalignment of up to 2 % and offsets of up to
+ * 80 mg, plus ±1 mg of noise. The solved correction must map both the calibration readings and an unseen
+ * orientation back to within 3 mg, must reject degenerate readings, and must reach the output of the driver.
+ */
+bool check_accel_calibration(MPU6050 &imu)
+{
+    // An accelerometer with this scale and misalignment reads `error * g + offset`, which is an `AccelCorrection`
+    // as well.
+    AccelCorrection fault{.matrix = {{1.02f, 0.01f, -0.015f}, {0.005f, 0.98f, 0.02f}, {-0.01f, 0.012f, 1.01f}},
+                          .offset = {0.05f, -0.03f, 0.08f}};
+    auto apply = [](const AccelCorrection &c, const glm::vec3 &v) {
+        glm::vec3 out;
+        for (int r = 0; r != 3; ++r) {
+            out[r] = c.matrix[r][0] * v.x + c.matrix[r][1] * v.y + c.matrix[r][2] * v.z + c.offset[r];
+        }
+        return out;
+    };
+    auto read = [&](const glm::vec3 &g, size_t i) {
+        const float noise = (i % 3 == 0 ? 1e-3f : -1e-3f) * (i % 2 == 0 ? 1.0f : -0.5f);
+        return apply(fault, g) + glm::vec3(noise, -noise, 0.5f * noise);
+    };
+
+    std::array<glm::vec3, AccelCalibration::ORIENTATION_COUNT> measured;
+    for (size_t i = 0; i != measured.size(); ++i) {
+        measured[i] = read(AccelCalibration::get_expected(static_cast<AccelOrientation>(i)), i);
+    }
+    const std::optional<AccelCorrection> correction = AccelCalibration::solve(measured);
+    if (!correction) {
+        ESP_LOGE(TAG, "Accel calibration: no solution");
+        return false;
+    }
+
+    float max_error = 0.0f;
+    for (size_t i = 0; i != measured.size(); ++i) {
+        const glm::vec3 expected = AccelCalibration::get_expected(static_cast<AccelOrientation>(i));
+        max_error = std::max(max_error, glm::length(apply(*correction, measured[i]) - expected));
+    }
+    const glm::vec3 tilted = glm::normalize(glm::vec3(0.3f, -0.5f, 0.8f));
+    const float unseen_error = glm::length(apply(*correction, read(tilted, 1)) - tilted);
+
+    std::array<glm::vec3, AccelCalibration::ORIENTATION_COUNT> degenerate;
+    degenerate.fill(glm::vec3(0.0f, 0.0f, 1.0f));
+
+    // The frame reads az = 1 g; a pure offset of -0.25 g must come out of the driver as 0.75 g.
+    AccelCorrection shift;
+    shift.offset[2] = -0.25f;
+    imu.set_accel_correction(shift);
+    const float shifted_az = imu.get_data().az;
+    imu.set_accel_correction({});
+
+    const bool ok = max_error < 3e-3f && unseen_error < 3e-3f && !AccelCalibration::solve(degenerate) &&
+                    shifted_az == 0.75f;
+    ESP_LOGI(TAG,
+             "Accel calibration: scale (%.4f, %.4f, %.4f), residual %.2f mg, unseen %.2f mg, %s",
+             correction->matrix[0][0],
+             correction->matrix[1][1],
+             correction->matrix[2][2],
+             max_error * 1e3f,
+             unseen_error * 1e3f,
+             ok ? "ok" : "FAILED");
+    return ok;
+}
+
+/**
+ * @brief Stands in for the control loop wake-up: counts the data-ready edges it is called for.
+ */
+void count_wakeup(void *context)
+{
+    ++*static_cast<uint64_t *>(context);
+}
+
+/**
+ * @brief Raises one data-ready edge and checks that it woke the "control loop" and stamped the next sample.
+ */
+bool check_data_ready(MPU6050 &imu, const uint64_t &wakeups)
+{
+    const uint64_t wakeups_before = wakeups;
+    const uint32_t edges_before = imu.get_data_ready_count();
+    const int64_t before_us = esp_timer_get_time();
+    SimGpio::get_instance().raise(MPU6050_INT_PIN);
+    const int64_t after_us = esp_timer_get_time();
+    const IMUData data = imu.get_data();
+
+    const bool ok = wakeups == wakeups_before + 1 && imu.get_data_ready_count() == edges_before + 1 &&
+                    data.timestamp_us >= before_us && data.timestamp_us <= after_us;
+    ESP_LOGI(TAG,
+             "Data-ready: edge stamped %lld us after raise, wake-up %s",
+             static_cast<long long>(data.timestamp_us - before_us),
+             ok ? "ok" : "MISSING");
+    return ok;
+}
+} // namespace
+
+/**
+ * @brief Host microbenchmark of the sensor read path.
+ *
+ * Usage: `kopter_i2c_bench [iterations]`
+ *
+ * Runs the real `MPU6050` and `BMP280` drivers against `SimI2cBus` register maps and reports the time, bus
+ * transfers and heap allocations per read, followed by the `I2cStats` of both devices. The bus is free here,
+ * so the time is the driver overhead alone. The FIFO case drains four frames per call, as a control loop
+ * running at a quarter of the sample rate would. The data-ready case raises the INT edge on `SimGpio` before
+ * every read and checks once that the edge wakes the caller and stamps the sample. `I2cBusScheduler` runs its bus
+ * task on a host thread; its priority order is checked and the round trip of a blocking read through it is
+ * measured over a hundredth of the iterations, against the direct read. Beforehand it checks that the
+ * 14-byte burst is decoded field by field from the register map, that a non-default `MPU6050Config` reaches the
+ * registers and the mapper, that `GyroCalibration` removes the gyroscope offsets of the frame, cold and
+ * warm-started, and that `AccelCalibration::solve` recovers the correction of a synthetic faulty accelerometer.
+ * For the barometer it checks the compensation against the datasheet example, the altitude table against the
+ * exact formula, that reads are cached between conversions, that the skipped reading before the first conversion
+ * is not taken as a sample, that profiles and forced mode reach the registers, that a forced start zeroes
+ * `AltitudeReference` at the ground, and that `AltitudeReference` rejects failed reads, zeroes on arming and
+ * applies a QNH. The mappers are also measured alone, the MPU6050 one per 7-value frame against the
+ * switch-and-divide mapping it replaced and the altitude table against `std::pow`.
+ *
+ * Exits with a failure status if any read allocated on the heap, a configuration or calibration check failed
+ * or the data-ready edge was lost, see `SimHeapGuard`.
+ */
+int main(int argc, char **argv)
+{
+    const uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : DEFAULT_ITERATIONS;
+    if (iterations == 0) {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    auto &bus = SimI2cBus::get_instance();
+    preset(bus.attach(MPU6050_ADDRESS), MPU6050_FRAME_REG, MPU6050_FRAME);
+    bus.attach_fifo(MPU6050_ADDRESS, MPU6050_FIFO_DATA_REG, MPU6050_FIFO_COUNT_REG);
+    preset(bus.attach(BMP280_ADDRESS), BMP280_CALIB_REG, BMP280_CALIB);
+    preset(bus.attach(BMP280_ADDRESS), BMP280_DATA_REG, BMP280_DATA);
+
+    MPU6050 imu(MPU6050_ADDRESS);
+    MPU6050 fifo_imu(MPU6050_ADDRESS);
+    fifo_imu.enable_fifo();
+    uint64_t wakeups = 0;
+    MPU6050 irq_imu(MPU6050_ADDRESS);
+    irq_imu.enable_data_ready_interrupt(MPU6050_INT_PIN, &count_wakeup, &wakeups);
+    BMP280 barometer(BMP280_ADDRESS);
+
+    const IMUData data = imu.get_data();
+    ESP_LOGI(TAG,
+             "MPU6050: a=(%.2f, %.2f, %.2f) g, g=(%.2f, %.2f, %.2f) deg/s, %.2f C",
+             data.ax,
+             data.ay,
+             data.az,
+             data.gx,
+             data.gy,
+             data.gz,
+             data.temperature);
+
+    volatile float sink = 0.0f;
+    bool ok = check_imu_frame(imu, bus.attach(MPU6050_ADDRESS));
+    ok &= check_barometer(barometer);
+    BMP280Mapper barometer_mapper;
+    ok &= check_altitude(barometer_mapper);
+    ok &= check_barometer_cache(bus.attach(BMP280_ADDRESS));
+    ok &= check_barometer_cold_start(bus.attach(BMP280_ADDRESS));
+    ok &= check_barometer_profiles(bus.attach(BMP280_ADDRESS));
+    ok &= check_forced_first_altitude();
+    ok &= check_altitude_reference();
+    ok &= check_config(bus.attach(MPU6050_ADDRESS));
+    ok &= check_gyro_calibration(imu);
+    ok &= check_accel_calibration(imu);
+    ok &= check_data_ready(irq_imu, wakeups);
+    ok &= measure("MPU6050::get_data", iterations, [&] { sink = imu.get_data().az; });
+    ok &= check_bus_scheduler(iterations);
+    ok &= measure("MPU6050::get_data (data-ready)", iterations, [&] {
+        SimGpio::get_instance().raise(MPU6050_INT_PIN);
+        sink = irq_imu.get_data().az;
+    });
+    std::array<IMUData, IMU::MAX_BATCH> batch;
+    ok &= measure("MPU6050::read_batch (FIFO x4)", iterations, [&] {
+        for (size_t i = 0; i != FIFO_BATCH; ++i) {
+            bus.push_fifo(MPU6050_ADDRESS, MPU6050_FRAME.data(), MPU6050_FRAME.size());
+        }
+        sink = batch[fifo_imu.read_batch(batch) - 1].az;
+    });
+
+    // The ranges are runtime values, as in the driver, the frame changes every call and every value is consumed,
+    // so nothing is hoisted or dropped.
+    volatile uint8_t accel_mode = static_cast<uint8_t>(AccelSensitivityMode::A8G);
+    volatile uint8_t gyro_mode = static_cast<uint8_t>(GyroSensitivityMode::DPS_1000);
+    const MPU6050Mapper mapper(static_cast<AccelSensitivityMode>(accel_mode),
+                               static_cast<GyroSensitivityMode>(gyro_mode));
+    MPU6050RawFrame raw{.ax = 10, .ay = -20, .az = 4096, .temperature = -3000, .gx = 131, .gy = -131, .gz = 7};
+    auto consume = [&sink](const IMUData &d) { sink = d.ax + d.ay + d.az + d.gx + d.gy + d.gz + d.temperature; };
+    ok &= measure("MPU6050Mapper::map (frame)", iterations, [&] {
+        ++raw.ax;
+        consume(mapper.map(raw));
+    });
+    ok &= measure("division per value (frame)", iterations, [&] {
+        ++raw.ax;
+        consume(map_by_division(
+            raw, static_cast<AccelSensitivityMode>(accel_mode), static_cast<GyroSensitivityMode>(gyro_mode)));
+    });
+    ok &= measure("BMP280::read_temperature", iterations, [&] { sink = barometer.read_temperature(); });
+    ok &= measure("BMP280::read_pressure", iterations, [&] { sink = barometer.read_pressure(); });
+    ok &= measure("BMP280::read_altitude", iterations, [&] { sink = barometer.read_altitude(); });
+    // Walks the envelope so that every call sees a new pressure.
+    volatile float pressure_step = 0.37f;
+    float pressure = 100000.0f;
+    auto next_pressure = [&] {
+        pressure = pressure < 60000.0f ? 100000.0f : pressure - pressure_step;
+        return pressure;
+    };
+    ok &= measure("BMP280Mapper::map_altitude", iterations, [&] {
+        sink = barometer_mapper.map_altitude(next_pressure());
+    });
+    ok &= measure("std::pow altitude", iterations, [&] { sink = map_altitude_by_pow(next_pressure()); });
+    I2cDeviceHolder::get_instance().log_stats();
+
+    if (!ok) {
+        ESP_LOGE(TAG, "Heap allocations or failed checks on the sensor read path");
+        return EXIT_FAILURE;
+    }
+    ESP_LOGI(TAG, "No heap allocations on the sensor read path");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,574 @@
+/*
+ Copyright 2025 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "pch.hpp"
+
+#include "AltitudeReference.hpp"
+#include "CascadePID.hpp"
+#include "ComplementaryFilter.hpp"
+#include "FlightController.hpp"
+#include "PressureAltitude.hpp"
+#include "QuadModel.hpp"
+#include "SimBarometer.hpp"
+#include "SimHeapGuard.hpp"
+#include "SimIMU.hpp"
+#include "SimMotor.hpp"
+#include "VerticalEstimator.hpp"
+#include "XMotorMixer.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace kopter;
+
+namespace {
+constexpr float DEFAULT_DURATION_S = 10.0f;
+constexpr uint32_t DEFAULT_RATE_HZ = 1000;
+constexpr uint32_t PHYSICS_SUBSTEPS = 4;
+constexpr uint32_t ATTITUDE_DIVIDER = 2;
+constexpr uint32_t ALTITUDE_DIVIDER = 64;
+constexpr float ANGLE_KP = 8.0f;
+constexpr float RATE_KP = 0.002f;
+constexpr float RATE_KI = 0.0f;
+constexpr float RATE_KD = 0.02f;
+constexpr float REPORT_PERIOD_S = 0.5f;
+constexpr float INITIAL_ALTITUDE = 1.0f;
+constexpr float HOVER_THROTTLE = 0.5f;
+constexpr float DISTURBANCE_START_S = 1.0f;
+constexpr float DISTURBANCE_DURATION_S = 0.05f;
+const glm::vec3 DISTURBANCE_TORQUE{2.0e-4f, -1.0e-4f, 0.0f};
+constexpr float STEP_START_S = 2.0f;
+constexpr float STEP_ROLL_DEG = 10.0f;
+constexpr float MICROS_PER_SECOND = 1e6f;
+constexpr float VERTICAL_ZERO_S = 2.0f;
+constexpr float VERTICAL_STEP_S = 1.0f;
+constexpr float VERTICAL_STEP_THROTTLE = 0.06f;
+constexpr float VERTICAL_SINE_THROTTLE = 0.04f;
+constexpr float VERTICAL_SINE_HZ = 0.7f;
+constexpr float VERTICAL_ACCEL_BIAS_G = 0.01f;
+constexpr uint32_t VERTICAL_BARO_FILTER = 4;
+constexpr float VERTICAL_MAX_LAG_S = 0.4f;
+constexpr float VERTICAL_NOISE_WINDOW_S = 0.5f;
+constexpr uint32_t GATING_TICKS = 256;
+constexpr float GATING_MAX_ALTITUDE = 0.1f;
+constexpr float ARMING_THROTTLE = 0.8f;
+constexpr float ARMED_MIN_CLIMB = 0.05f;
+constexpr float STALE_PRESSURE_PA = 100129.0f; // about 100 m above sea level
+constexpr const char *TAG = "[SIL]";
+
+struct Options {
+    float duration_s = DEFAULT_DURATION_S;
+    uint32_t rate_hz = DEFAULT_RATE_HZ;
+    bool static_pipeline = false;
+};
+
+Options parse_options(int argc, char **argv)
+{
+    Options options;
+    int position = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--static") == 0) {
+            options.static_pipeline = true;
+        }
+        else if (position++ == 0) {
+            options.duration_s = std::strtof(argv[i], nullptr);
+        }
+        else {
+            options.rate_hz = static_cast<uint32_t>(std::strtoul(argv[i], nullptr, 10));
+        }
+    }
+    return options;
+}
+
+/**
+ * @brief Rise time (10–90 %) and overshoot of a step response.
+ */
+struct StepMetrics {
+    void update(float t, float value)
+    {
+        const float progress = value / target;
+        if (rise_start_s < 0.0f && progress >= 0.1f) {
+            rise_start_s = t;
+        }
+        if (rise_end_s < 0.0f && progress >= 0.9f) {
+            rise_end_s = t;
+        }
+        peak = std::max(peak, progress);
+    }
+
+    float target;
+    float rise_start_s = -1.0f;
+    float rise_end_s = -1.0f;
+    float peak = 0.0f;
+};
+
+glm::vec3 get_euler_degrees(const glm::quat &q)
+{
+    const glm::vec3 eulers = glm::eulerAngles(q);
+    return {glm::degrees(eulers.x), glm::degrees(eulers.y), glm::degrees(eulers.z)};
+}
+
+std::unique_ptr<CascadePID> make_cascade()
+{
+    return std::make_unique<CascadePID>(std::make_unique<PID>(ANGLE_KP),
+                                        std::make_unique<PID>(RATE_KP, RATE_KI, RATE_KD));
+}
+
+/**
+ * @brief Runs the scenario with the given controller and prints the results.
+ *
+ * @param controller `FlightController` or a `FlightPipeline` over the simulated components of `model`.
+ * @param model Simulated quadrotor closed with `controller`.
+ * @param options Duration and control rate.
+ * @return true if `update_speed` ran without heap allocations.
+ */
+template <typename Controller> bool simulate(Controller &controller, QuadModel &model, const Options &options)
+{
+    StepMetrics step{.target = STEP_ROLL_DEG};
+    SetpointChannel &setpoints = controller.get_setpoint_channel();
+
+    controller.set_loop_dividers({.attitude = ATTITUDE_DIVIDER, .altitude = ALTITUDE_DIVIDER});
+    setpoints.publish({.throttle = HOVER_THROTTLE, .armed = true});
+
+    const uint64_t period_us = static_cast<uint64_t>(MICROS_PER_SECOND) / options.rate_hz;
+    const float dt = period_us / MICROS_PER_SECOND;
+    const uint64_t ticks = static_cast<uint64_t>(options.duration_s * options.rate_hz);
+    const uint64_t report_every = std::max<uint64_t>(1, static_cast<uint64_t>(REPORT_PERIOD_S * options.rate_hz));
+
+    ESP_LOGI(TAG, "Running %.1f s at %lu Hz", options.duration_s, static_cast<unsigned long>(options.rate_hz));
+    const auto wall_start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration controller_time{};
+
+    uint64_t now_us = period_us;
+    for (uint64_t tick = 1; tick <= ticks; ++tick, now_us += period_us) {
+        const float now_s = now_us / MICROS_PER_SECOND;
+        const bool disturbed = now_s >= DISTURBANCE_START_S && now_s < DISTURBANCE_START_S + DISTURBANCE_DURATION_S;
+        model.set_disturbance_torque(disturbed ? DISTURBANCE_TORQUE : glm::vec3(0.0f));
+        if (tick == static_cast<uint64_t>(STEP_START_S * options.rate_hz)) {
+            setpoints.publish(
+                {.throttle = HOVER_THROTTLE,
+                 .roll = STEP_ROLL_DEG,
+                 .armed = true,
+                 .timestamp_us = static_cast<int64_t>(now_us)});
+        }
+
+        for (uint32_t i = 0; i != PHYSICS_SUBSTEPS; ++i) {
+            model.step(dt / PHYSICS_SUBSTEPS);
+        }
+        const auto update_start = std::chrono::steady_clock::now();
+        SimHeapGuard::arm();
+        controller.update_speed(now_us);
+        SimHeapGuard::disarm();
+        controller_time += std::chrono::steady_clock::now() - update_start;
+
+        if (now_s >= STEP_START_S) {
+            step.update(now_s - STEP_START_S, get_euler_degrees(model.get_state().attitude).x);
+        }
+
+        if (tick % report_every == 0) {
+            const auto &state = model.get_state();
+            const glm::vec3 attitude = get_euler_degrees(state.attitude);
+            ESP_LOGI(TAG,
+                     "t=%6.2f s roll=%7.2f pitch=%7.2f yaw=%7.2f deg alt=%6.3f m",
+                     now_s,
+                     attitude.x,
+                     attitude.y,
+                     attitude.z,
+                     state.position.z);
+        }
+    }
+
+    const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wall_start;
+    if (step.rise_end_s >= 0.0f) {
+        ESP_LOGI(TAG,
+                 "Roll step %.0f deg: rise time %.0f ms, overshoot %.1f %%",
+                 STEP_ROLL_DEG,
+                 (step.rise_end_s - step.rise_start_s) * 1e3f,
+                 (step.peak - 1.0f) * 100.0f);
+    }
+    const SetpointStats setpoint_stats = setpoints.get_stats();
+    ESP_LOGI(TAG,
+             "Setpoints: %lu received, %lu overwritten, max latency %ld us",
+             static_cast<unsigned long>(setpoint_stats.received),
+             static_cast<unsigned long>(setpoint_stats.overwritten),
+             static_cast<long>(setpoint_stats.max_latency_us));
+    ESP_LOGI(TAG,
+             "Simulated %.2f s in %.3f s wall (%.0fx real time, %.0f ns/tick, %.0f ns/tick in update_speed)",
+             options.duration_s,
+             wall.count(),
+             options.duration_s / wall.count(),
+             wall.count() * 1e9 / ticks,
+             std::chrono::duration<double, std::nano>(controller_time).count() / ticks);
+#if CONFIG_FLIGHT_LOOP_PROFILING
+    controller.get_profiler().log_stats();
+#endif
+
+    const uint64_t allocations = SimHeapGuard::get_violations();
+    if (allocations != 0) {
+        ESP_LOGE(TAG, "%llu heap allocations in update_speed", static_cast<unsigned long long>(allocations));
+        return false;
+    }
+    ESP_LOGI(TAG, "No heap allocations in update_speed");
+    return true;
+}
+/**
+ * @brief Error of an altitude signal against the true altitude.
+ */
+struct AltitudeError {
+    /// Mean error in meters.
+    float bias;
+    /// Delay behind the true altitude that minimizes the spread of the error, in seconds.
+    float lag_s;
+    /// Standard deviation of the error once the signal is shifted back by `lag_s`, in meters.
+    float spread;
+    /// Standard deviation of the part of that error faster than `VERTICAL_NOISE_WINDOW_S`, in meters.
+    float noise;
+};
+
+/**
+ * @brief Returns the mean and the standard deviation of `signal[i] - truth[i - lag]`.
+ */
+std::pair<float, float> get_error_stats(const std::vector<float> &signal, const std::vector<float> &truth, size_t lag)
+{
+    double sum = 0.0;
+    double sum_squares = 0.0;
+    for (size_t i = lag; i != signal.size(); ++i) {
+        const double error = signal[i] - truth[i - lag];
+        sum += error;
+        sum_squares += error * error;
+    }
+    const double count = static_cast<double>(signal.size() - lag);
+    const double mean = sum / count;
+    return {static_cast<float>(mean), static_cast<float>(std::sqrt(std::max(0.0, sum_squares / count - mean * mean)))};
+}
+
+AltitudeError get_altitude_error(const std::vector<float> &signal, const std::vector<float> &truth, float dt)
+{
+    AltitudeError result{};
+    size_t best_lag = 0;
+    std::tie(result.bias, result.spread) = get_error_stats(signal, truth, 0);
+
+    const size_t max_lag = std::min(signal.size() / 2, static_cast<size_t>(VERTICAL_MAX_LAG_S / dt));
+    for (size_t lag = 1; lag <= max_lag; ++lag) {
+        const float spread = get_error_stats(signal, truth, lag).second;
+        if (spread < result.spread) {
+            result.spread = spread;
+            best_lag = lag;
+        }
+    }
+    result.lag_s = best_lag * dt;
+
+    // Fast part of the error: its deviation from a centered moving average.
+    const size_t half_window = std::max<size_t>(1, static_cast<size_t>(VERTICAL_NOISE_WINDOW_S / dt / 2.0f));
+    std::vector<double> error_sums{0.0};
+    for (size_t i = best_lag; i != signal.size(); ++i) {
+        error_sums.push_back(error_sums.back() + signal[i] - truth[i - best_lag]);
+    }
+    double sum_squares = 0.0;
+    size_t count = 0;
+    for (size_t i = half_window; i + half_window + 1 < error_sums.size(); ++i) {
+        const double error = error_sums[i + 1] - error_sums[i];
+        const double average = (error_sums[i + half_window + 1] - error_sums[i - half_window]) / (2 * half_window + 1);
+        sum_squares += (error - average) * (error - average);
+        ++count;
+    }
+    result.noise = count != 0 ? static_cast<float>(std::sqrt(sum_squares / count)) : 0.0f;
+    return result;
+}
+
+/**
+ * @brief Flies the model open loop through vertical steps and a sine and compares the barometric altitude and the
+ * `VerticalEstimator` output with the true altitude.
+ *
+ * The quadrotor rests on the ground while `AltitudeReference` zeroes, is armed at takeoff, then climbs and
+ * descends with the throttle stepped around hover and finally oscillates. The barometer runs its IIR filter, as on
+ * the board, and the accelerometer has a constant vertical bias for the estimator to learn.
+ *
+ * @param options Control rate.
+ * @return true if the estimate lags less and is less noisy than the barometer.
+ */
+bool evaluate_vertical_estimator(const Options &options)
+{
+    QuadModel model;
+    model.reset(glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    SimIMU imu(model);
+    imu.set_accel_correction({.offset = {0.0f, 0.0f, VERTICAL_ACCEL_BIAS_G}});
+    SimBarometer barometer(model, 0.0f, 1.5f, 2, VERTICAL_BARO_FILTER);
+    ComplementaryFilter orientation_filter(0.9998f);
+    AltitudeReference reference;
+    VerticalEstimator estimator;
+
+    const QuadModelParams params{};
+    const float hover_throttle = std::sqrt(params.mass * QuadModel::GRAVITY / (4.0f * params.max_thrust));
+    const uint64_t period_us = static_cast<uint64_t>(MICROS_PER_SECOND) / options.rate_hz;
+    const float dt = period_us / MICROS_PER_SECOND;
+    const uint64_t ticks = static_cast<uint64_t>(options.duration_s * options.rate_hz);
+
+    std::vector<float> truth;
+    std::vector<float> baro;
+    std::vector<float> estimate;
+    float altitude = 0.0f;
+    double velocity_error = 0.0;
+
+    uint64_t now_us = period_us;
+    for (uint64_t tick = 1; tick <= ticks; ++tick, now_us += period_us) {
+        const float now_s = now_us / MICROS_PER_SECOND;
+        const float flight_s = now_s - VERTICAL_ZERO_S;
+        float throttle = 0.0f;
+        if (flight_s >= 2.0f * VERTICAL_STEP_S) {
+            throttle = hover_throttle + VERTICAL_SINE_THROTTLE * std::sin(2.0f * glm::pi<float>() * VERTICAL_SINE_HZ *
+                                                                          (flight_s - 2.0f * VERTICAL_STEP_S));
+        }
+        else if (flight_s >= VERTICAL_STEP_S) {
+            throttle = hover_throttle - VERTICAL_STEP_THROTTLE;
+        }
+        else if (flight_s >= 0.0f) {
+            throttle = hover_throttle + VERTICAL_STEP_THROTTLE;
+        }
+        for (size_t motor = 0; motor != 4; ++motor) {
+            model.set_throttle(motor, throttle);
+        }
+        reference.set_armed(flight_s >= 0.0f);
+
+        for (uint32_t i = 0; i != PHYSICS_SUBSTEPS; ++i) {
+            model.step(dt / PHYSICS_SUBSTEPS);
+        }
+        const IMUData sample = imu.get_data();
+        orientation_filter.update(sample, static_cast<int64_t>(now_us));
+        estimator.predict(sample, orientation_filter.get_quat(), static_cast<int64_t>(now_us));
+        if (tick % ALTITUDE_DIVIDER == 0) {
+            if (const std::optional<float> relative_altitude = reference.update(barometer.read_pressure())) {
+                altitude = *relative_altitude;
+                estimator.correct(altitude);
+            }
+        }
+
+        if (flight_s >= 0.0f) {
+            truth.push_back(model.get_state().position.z);
+            baro.push_back(altitude);
+            estimate.push_back(estimator.get_altitude());
+            const float error = estimator.get_velocity() - model.get_state().velocity.z;
+            velocity_error += error * error;
+        }
+    }
+    if (truth.empty()) {
+        return true;
+    }
+
+    const AltitudeError baro_error = get_altitude_error(baro, truth, dt);
+    const AltitudeError estimate_error = get_altitude_error(estimate, truth, dt);
+    ESP_LOGI(TAG,
+             "Vertical: barometer bias %6.3f m, lag %3.0f ms, spread %5.3f m, noise %5.3f m",
+             baro_error.bias,
+             baro_error.lag_s * 1e3f,
+             baro_error.spread,
+             baro_error.noise);
+    ESP_LOGI(TAG,
+             "Vertical: estimator bias %6.3f m, lag %3.0f ms, spread %5.3f m, noise %5.3f m, velocity error %5.3f m/s "
+             "rms, accel bias %5.3f m/s2",
+             estimate_error.bias,
+             estimate_error.lag_s * 1e3f,
+             estimate_error.spread,
+             estimate_error.noise,
+             std::sqrt(velocity_error / truth.size()),
+             estimator.get_accel_bias());
+
+    if (estimate_error.lag_s >= baro_error.lag_s || estimate_error.noise >= baro_error.noise) {
+        ESP_LOGE(TAG, "Vertical estimator does not improve on the barometer");
+        return false;
+    }
+    return true;
+}
+/**
+ * @brief Barometer that converts on every `READS_PER_CONVERSION`-th read, at sea level, and returns the pressure
+ * about 100 m up on the reads in between. A pipeline that used reads without a new sample would follow them.
+ */
+class StaleReadBarometer : public IBarometer {
+public:
+    static constexpr uint32_t READS_PER_CONVERSION = 4;
+
+    const char *get_name() const noexcept override
+    {
+        return "[StaleReadBarometer]";
+    }
+
+    float read_temperature() override
+    {
+        return 20.0f;
+    }
+
+    float read_pressure() override
+    {
+        m_new_sample = m_reads++ % READS_PER_CONVERSION == 0;
+        return m_new_sample ? PressureAltitude::SEA_LEVEL_PRESSURE : STALE_PRESSURE_PA;
+    }
+
+    float read_altitude() override
+    {
+        return PressureAltitude::to_altitude(read_pressure());
+    }
+
+    bool has_new_sample() const noexcept override
+    {
+        return m_new_sample;
+    }
+
+private:
+    uint32_t m_reads = 0;
+    bool m_new_sample = false;
+};
+
+/**
+ * @brief Runs a `FlightPipeline` on the ground with a barometer that converts on every fourth altitude tick and
+ * checks that neither the zero nor the vertical estimator take the reads in between.
+ */
+bool check_altitude_gating()
+{
+    QuadModel model;
+    model.reset(glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    FlightPipeline<SimIMU, StaleReadBarometer, ComplementaryFilter, XMotorMixer, SimMotor> pipeline(
+        SimIMU{model},
+        StaleReadBarometer{},
+        ComplementaryFilter{0.9998f},
+        XMotorMixer{},
+        {SimMotor{model, 0}, SimMotor{model, 1}, SimMotor{model, 2}, SimMotor{model, 3}});
+
+    const uint64_t period_us = static_cast<uint64_t>(MICROS_PER_SECOND) / DEFAULT_RATE_HZ;
+    uint64_t now_us = period_us;
+    for (uint32_t tick = 0; tick != GATING_TICKS; ++tick, now_us += period_us) {
+        model.step(period_us / MICROS_PER_SECOND);
+        pipeline.update_speed(now_us);
+    }
+
+    const float altitude = pipeline.get_vertical_estimator().get_altitude();
+    const float elevation = pipeline.get_altitude_reference().get_ground_elevation();
+    const bool ok = std::abs(altitude) < GATING_MAX_ALTITUDE && std::abs(elevation) < GATING_MAX_ALTITUDE;
+    ESP_LOGI(TAG,
+             "Altitude gating: estimate %.3f m, ground elevation %.3f m with stale reads 100 m up, %s",
+             altitude,
+             elevation,
+             ok ? "ok" : "FAILED");
+    return ok;
+}
+/**
+ * @brief Runs a `FlightPipeline` on the ground with the throttle high, first disarmed, then armed, and checks that
+ * the quadrotor only takes off once armed.
+ */
+bool check_disarmed_motors()
+{
+    QuadModel model;
+    model.reset(glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    FlightPipeline<SimIMU, SimBarometer, ComplementaryFilter, XMotorMixer, SimMotor> pipeline(
+        SimIMU{model},
+        SimBarometer{model},
+        ComplementaryFilter{0.9998f},
+        XMotorMixer{},
+        {SimMotor{model, 0}, SimMotor{model, 1}, SimMotor{model, 2}, SimMotor{model, 3}});
+
+    const uint64_t period_us = static_cast<uint64_t>(MICROS_PER_SECOND) / DEFAULT_RATE_HZ;
+    uint64_t now_us = period_us;
+    auto fly = [&](bool armed) {
+        pipeline.get_setpoint_channel().publish(
+            {.throttle = ARMING_THROTTLE, .armed = armed, .timestamp_us = static_cast<int64_t>(now_us)});
+        for (uint32_t tick = 0; tick != GATING_TICKS; ++tick, now_us += period_us) {
+            model.step(period_us / MICROS_PER_SECOND);
+            pipeline.update_speed(now_us);
+        }
+        return model.get_state().position.z;
+    };
+    const float disarmed_altitude = fly(false);
+    const float armed_altitude = fly(true);
+
+    const bool ok = disarmed_altitude == 0.0f && armed_altitude > ARMED_MIN_CLIMB;
+    ESP_LOGI(TAG,
+             "Arming: %.0f %% throttle holds %.3f m disarmed, climbs to %.3f m armed, %s",
+             ARMING_THROTTLE * 100.0f,
+             disarmed_altitude,
+             armed_altitude,
+             ok ? "ok" : "FAILED");
+    return ok;
+}
+} // namespace
+
+/**
+ * @brief Software-in-the-loop runner.
+ *
+ * Usage: `kopter_sil [--static] [duration_s] [rate_hz]`
+ *
+ * Closes the loop between the flight controller and `QuadModel` at the given control rate, starting from a level
+ * hover that is hit by a short torque disturbance and then by a roll setpoint step, and runs as fast as the
+ * host allows. Prints the true attitude and altitude periodically, and the step response metrics and
+ * the real-time factor at the end. Then flies the vertical scenario of `evaluate_vertical_estimator` for the same
+ * duration and prints the lag and noise of the barometric and the estimated altitude.
+ *
+ * By default the runtime `FlightController` is used; `--static` runs the same scenario on a `FlightPipeline`
+ * holding the simulated components by value, so the ns/tick of both forms can be compared.
+ *
+ * Exits with a failure status if `update_speed` allocated on the heap, see `SimHeapGuard`, if the estimated
+ * altitude does not improve on the barometric one, or if the altitude loop takes barometer reads without a new
+ * sample, see `check_altitude_gating`, or if a disarmed pipeline spins the motors, see `check_disarmed_motors`.
+ */
+int main(int argc, char **argv)
+{
+    const Options options = parse_options(argc, argv);
+    if (options.duration_s <= 0.0f || options.rate_hz == 0) {
+        fprintf(stderr, "Usage: %s [--static] [duration_s] [rate_hz]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    QuadModel model;
+    model.reset(glm::vec3(0.0f, 0.0f, INITIAL_ALTITUDE), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+
+    if (options.static_pipeline) {
+        ESP_LOGI(TAG, "Using the statically composed pipeline");
+        FlightPipeline<SimIMU, SimBarometer, ComplementaryFilter, XMotorMixer, SimMotor> controller(
+            SimIMU{model},
+            SimBarometer{model},
+            ComplementaryFilter{0.9998f},
+            XMotorMixer{},
+            {SimMotor{model, 0}, SimMotor{model, 1}, SimMotor{model, 2}, SimMotor{model, 3}},
+            make_cascade(),
+            make_cascade(),
+            make_cascade(),
+            std::make_unique<PID>(0.1f, 0.0f, 0.0f));
+        const bool allocation_free = simulate(controller, model, options);
+        const bool checks_passed = check_altitude_gating() && check_disarmed_motors();
+        return allocation_free && evaluate_vertical_estimator(options) && checks_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    else {
+        std::array<std::unique_ptr<IMotor>, 4> motors = {std::make_unique<SimMotor>(model, 0),
+                                                         std::make_unique<SimMotor>(model, 1),
+                                                         std::make_unique<SimMotor>(model, 2),
+                                                         std::make_unique<SimMotor>(model, 3)};
+        FlightController controller(std::make_unique<SimIMU>(model),
+                                    std::make_unique<SimBarometer>(model),
+                                    std::make_unique<ComplementaryFilter>(0.9998f),
+                                    std::make_unique<XMotorMixer>(),
+                                    std::move(motors),
+                                    make_cascade(),
+                                    make_cascade(),
+                                    make_cascade(),
+                                    std::make_unique<PID>(0.1f, 0.0f, 0.0f));
+        const bool allocation_free = simulate(controller, model, options);
+        const bool checks_passed = check_altitude_gating() && check_disarmed_motors();
+        return allocation_free && evaluate_vertical_estimator(options) && checks_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+}